@@ -0,0 +1,76 @@
+#include "arena.hpp"
+
+// ============================================================================================
+// PUBLIC =====================================================================================
+// ============================================================================================
+
+// CTOR
+arena_t::arena_t() : cursor_(nullptr), end_(nullptr), bytes_in_use_(0), high_water_mark_(0), bytes_reserved_(0) { }
+arena_t::~arena_t() {release();}
+
+// ALLOCATION
+void * arena_t::allocate(size_t bytes) {
+  size_t k = size_class(bytes);
+  size_t block_size = alignment << k;
+  bytes_in_use_ += block_size;
+  if (bytes_in_use_ > high_water_mark_) high_water_mark_ = bytes_in_use_;
+  if (k < free_lists_.size() && free_lists_[k] != nullptr) {
+    free_block_t * block = free_lists_[k];
+    free_lists_[k] = block->next;
+    return block;
+  }
+  if ((size_t) (end_ - cursor_) < block_size) new_chunk(block_size);
+  void * block = cursor_;
+  cursor_ += block_size;
+  return block;
+}
+void arena_t::deallocate(void * block, size_t bytes) {
+  if (block == nullptr) return;
+  size_t k = size_class(bytes);
+  assert(bytes_in_use_ >= (alignment << k));
+  bytes_in_use_ -= alignment << k;
+  push_free_block(block, k);
+}
+void arena_t::release() {
+  for (auto it = chunks_.begin(); it != chunks_.end(); ++it) ::operator delete(*it);
+  chunks_.clear();
+  free_lists_.clear();
+  cursor_ = end_ = nullptr;
+  bytes_in_use_ = high_water_mark_ = bytes_reserved_ = 0;
+}
+
+// STATISTICS
+size_t arena_t::bytes_in_use() const {return bytes_in_use_;}
+size_t arena_t::high_water_mark() const {return high_water_mark_;}
+size_t arena_t::bytes_reserved() const {return bytes_reserved_;}
+
+// ============================================================================================
+// PRIVATE ====================================================================================
+// ============================================================================================
+
+size_t arena_t::size_class(size_t bytes) {
+  // smallest k such that (alignment << k) >= bytes, with alignment = 2^3.
+  if (bytes <= alignment) return 0;
+  return 64 - __builtin_clzll((unsigned long long) bytes - 1) - 3;
+}
+void arena_t::new_chunk(size_t bytes) {
+  // Recycle the end of the current chunk: cut it in blocks of decreasing size classes.
+  // The cursor is a multiple of the block sizes carved so far, which keeps every block aligned.
+  while (end_ - cursor_ >= (ptrdiff_t) alignment) {
+    size_t k = 0;
+    while ((alignment << (k + 1)) <= (size_t) (end_ - cursor_)) ++k;
+    push_free_block(cursor_, k);
+    cursor_ += alignment << k;
+  }
+  size_t size = bytes > chunk_size ? bytes : chunk_size;
+  chunks_.push_back(static_cast<char*>(::operator new(size)));
+  cursor_ = chunks_.back();
+  end_ = cursor_ + size;
+  bytes_reserved_ += size;
+}
+void arena_t::push_free_block(void * block, size_t size_class) {
+  if (free_lists_.size() <= size_class) free_lists_.resize(size_class + 1, nullptr);
+  free_block_t * head = static_cast<free_block_t*>(block);
+  head->next = free_lists_[size_class];
+  free_lists_[size_class] = head;
+}
@@ -0,0 +1,136 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+/**
+  * @file arena.hpp
+  * @brief Memory arena backing the containers of a network, and matching allocator.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <assert.h> // error checking: turn off with #define NDEBUG
+#include <stddef.h> // size_t
+// STL
+#include <new>      // ::operator new
+#include <type_traits> // std::true_type
+#include <vector>   // chunks and free lists, arena_vector_t
+
+/** @class arena_t
+  * @brief Chunked pool allocator, released in bulk.
+  *
+  *  Blocks are rounded up to a power of two (at least @p alignment bytes) and 
+  *  carved out of large chunks by a pointer bump. Freed blocks are kept in one 
+  *  free list per size class and reused by the next allocation of the same class,
+  *  such that growing containers do not waste the arena.
+  *
+  *  Chunks are only returned to the system by release() or by the destructor: 
+  *  objects whose memory comes from the arena need not be destroyed one by one,
+  *  which turns the teardown of a network into O(number of chunks).
+  *
+  *  @warning Not thread safe.
+  */
+class arena_t {
+public:
+  /// Alignment of every block.
+  static const size_t alignment = 8;
+  /// Size of the chunks requested to the system (larger blocks get their own chunk).
+  static const size_t chunk_size = (size_t) 1 << 20;
+
+  /** @name Constructor */
+  //@{
+  arena_t();
+  ~arena_t();
+  //@}
+
+  /** @name Allocation */
+  //@{
+  /** Return a block of at least @p bytes bytes. */
+  void * allocate(size_t bytes);
+  /** Give back a block obtained from allocate(@p bytes). */
+  void deallocate(void * block, size_t bytes);
+  /** Return every chunk to the system. Every block is invalidated. */
+  void release();
+  //@}
+
+  /** @name Statistics (in bytes) */
+  //@{
+  /** Size of the blocks currently in use. */
+  size_t bytes_in_use() const;
+  /** Largest value of bytes_in_use() since the creation (or release) of the arena. */
+  size_t high_water_mark() const;
+  /** Size of the chunks obtained from the system. */
+  size_t bytes_reserved() const;
+  //@}
+
+private:
+  arena_t(const arena_t &);
+  arena_t & operator=(const arena_t &);
+
+  /// Node of the free lists, stored in the free block itself.
+  struct free_block_t {free_block_t * next;};
+  /** Size class of a request: blocks of class k are (alignment << k) bytes large. */
+  static size_t size_class(size_t bytes);
+  /** Start a new chunk of at least @p bytes bytes; the end of the current chunk goes to the free lists. */
+  void new_chunk(size_t bytes);
+  void push_free_block(void * block, size_t size_class);
+
+  /** @name Private data members */
+  //@{
+  /// Chunks obtained from the system.
+  std::vector<char*> chunks_;
+  /// Head of the free list of each size class.
+  std::vector<free_block_t*> free_lists_;
+  /// Bump pointer in the current chunk.
+  char * cursor_;
+  /// End of the current chunk.
+  char * end_;
+  size_t bytes_in_use_;
+  size_t high_water_mark_;
+  size_t bytes_reserved_;
+  //@}
+};
+
+/** @class arena_allocator_t
+  * @brief Standard allocator drawing its memory from an arena_t.
+  *
+  *  A default constructed allocator uses the global operator new, such that 
+  *  containers may be used without an arena.
+  */
+template <typename T>
+class arena_allocator_t {
+public:
+  typedef T value_type;
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+  static_assert(alignof(T) <= arena_t::alignment, "arena blocks are not aligned enough for this type");
+
+  arena_allocator_t() : arena_(nullptr) { }
+  explicit arena_allocator_t(arena_t * arena) : arena_(arena) { }
+  template <typename U> arena_allocator_t(const arena_allocator_t<U> & other) : arena_(other.arena()) { }
+
+  T * allocate(size_t n) {
+    if (arena_ == nullptr) return static_cast<T*>(::operator new(n * sizeof(T)));
+    return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+  }
+  void deallocate(T * block, size_t n) {
+    if (arena_ == nullptr) ::operator delete(block);
+    else arena_->deallocate(block, n * sizeof(T));
+  }
+  arena_t * arena() const {return arena_;}
+
+private:
+  arena_t * arena_;
+};
+template <typename T, typename U>
+inline bool operator==(const arena_allocator_t<T> & a, const arena_allocator_t<U> & b) {return a.arena() == b.arena();}
+template <typename T, typename U>
+inline bool operator!=(const arena_allocator_t<T> & a, const arena_allocator_t<U> & b) {return a.arena() != b.arena();}
+
+/// Vector whose storage comes from an arena.
+template <typename T> using arena_vector_t = std::vector<T, arena_allocator_t<T> >;
+
+#endif //ARENA_HPP
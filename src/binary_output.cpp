@@ -0,0 +1,97 @@
+#include "binary_output.hpp"
+
+// C libraries
+#include <string.h> // memset, memcpy
+// STL
+#include <vector> // offsets and neighbours
+
+// Helpers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace {
+  /// Extension of the paths that are always written in binary.
+  const std::string csr_extension = ".csr";
+
+  /** Write the header and the offsets of a CSR file (the entries follow). */
+  void write_csr_prefix(csr_kind_t kind, uint64_t columns, const std::vector<uint64_t> & offsets, std::ostream& os) {
+    csr_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "SPA-CSR", 8);
+    header.version = csr_version;
+    header.byte_order = csr_byte_order;
+    header.kind = kind;
+    header.entry_size = sizeof(id_t);
+    header.rows = offsets.size() - 1;
+    header.entries = offsets.back();
+    header.columns = columns;
+    header.offsets_position = sizeof(header);
+    header.entries_position = header.offsets_position + offsets.size() * sizeof(uint64_t);
+    os.write((const char *) &header, sizeof(header));
+    os.write((const char *) offsets.data(), offsets.size() * sizeof(uint64_t));
+    return;
+  }
+  /** Write the incidence lists of the rows of a CSR file, as they are stored. */
+  template <typename list_t>
+  void write_csr_lists(csr_kind_t kind, uint64_t columns, size_t rows, list_t list, std::ostream& os) {
+    std::vector<uint64_t> offsets(rows + 1, 0);
+    for (size_t row = 0; row < rows; ++row) offsets[row + 1] = offsets[row] + list(row).size();
+    write_csr_prefix(kind, columns, offsets, os);
+    for (size_t row = 0; row < rows; ++row) {
+      const incidence_list_t & entries = list(row);
+      os.write((const char *) entries.begin(), entries.size() * sizeof(id_t));
+    }
+    return;
+  }
+}
+
+// ============================================================================================
+// PUBLIC =====================================================================================
+// ============================================================================================
+
+bool is_valid_format_name(const std::string & format) {
+  return format == "text" || format == "binary" || format == "compressed";
+}
+bool is_binary_output(const std::string & path, const std::string & format) {
+  if (path.empty()) return false; // stdout
+  if (format == "binary") return true;
+  return path.size() >= csr_extension.size() && path.compare(path.size() - csr_extension.size(), csr_extension.size(), csr_extension) == 0;
+}
+bool binary_output_requested(const spa_parameters_t & param) {
+  const str_opt_t * outputs[] = {&param.edge_list, &param.connected_edge_list, &param.cluster_contents, &param.node_participations};
+  for (size_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); ++i) {
+    if (outputs[i]->initialized && is_binary_output(outputs[i]->value, param.format.value)) return true;
+  }
+  // compressed edge lists
+  for (size_t i = 0; i < 2; ++i) {
+    if (outputs[i]->initialized && is_compressed_output(outputs[i]->value, param.format.value)) return true;
+  }
+  return false;
+}
+void output_csr_edge_list(size_t nodes, const edge_list_t & edge_list, csr_kind_t kind, std::ostream& os) {
+  // degrees, then neighbours: the edges (u, v) are sorted, such that the neighbours
+  // w < v of a row v come first (in increasing order), then its neighbours w > v
+  std::vector<uint64_t> offsets(nodes + 1, 0);
+  for (auto it = edge_list.begin(); it != edge_list.end(); ++it) {
+    ++offsets[it->first + 1];
+    ++offsets[it->second + 1];
+  }
+  for (size_t node = 0; node < nodes; ++node) offsets[node + 1] += offsets[node];
+  std::vector<id_t> neighbours(offsets.back());
+  std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+  for (auto it = edge_list.begin(); it != edge_list.end(); ++it) {
+    neighbours[next[it->first]++] = it->second;
+    neighbours[next[it->second]++] = it->first;
+  }
+  std::vector<uint64_t>().swap(next);
+  write_csr_prefix(kind, nodes, offsets, os);
+  os.write((const char *) neighbours.data(), neighbours.size() * sizeof(id_t));
+  return;
+}
+void output_csr_cluster_contents(const spa_network_t & network, std::ostream& os) {
+  write_csr_lists(CSR_CLUSTER_CONTENTS, network.size_in_nodes(), network.size_in_clusters(),
+                  [&network](size_t cluster) -> const incidence_list_t & {return network.get_content(cluster);}, os);
+  return;
+}
+void output_csr_node_participations(const spa_network_t & network, std::ostream& os) {
+  write_csr_lists(CSR_NODE_PARTICIPATIONS, network.size_in_clusters(), network.size_in_nodes(),
+                  [&network](size_t node) -> const incidence_list_t & {return network.get_participations(node);}, os);
+  return;
+}
@@ -0,0 +1,106 @@
+#ifndef BINARY_OUTPUT_HPP
+#define BINARY_OUTPUT_HPP
+/**
+  * @file binary_output.hpp
+  * @brief Binary, memory-mappable outputs in the compressed sparse row (CSR) layout.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <stdint.h> // fixed width fields of the files
+#include <stddef.h> // size_t
+// STL
+#include <iostream> // ostream
+#include <string>   // paths and format names
+// Project files
+#include "spa_network.hpp" // spa_network_t
+#include "edge_list.hpp" // edge_list_t
+#include "compressed_edge_list.hpp" // is_compressed_output(2)
+// Typdef and helpers
+#include "types.hpp" // id_t, spa_parameters_t
+
+/** @name CSR files
+  * A CSR file is made of a header, an array of rows + 1 offsets (uint64_t) and an
+  * array of entries (uint32_t), in the byte order of the machine that wrote it:
+  *
+  *     [csr_header_t][offsets[0] ... offsets[rows]][entries[0] ... entries[entries - 1]]
+  *
+  * The entries of row i are entries[offsets[i]] to entries[offsets[i + 1] - 1], in the
+  * order of the lines of the text outputs (neighbours in increasing order). Both arrays
+  * start at the positions given in the header (8-byte aligned), such that a reader can
+  * map the file and cast the pointers directly:
+  *
+  *     const csr_header_t * header = (const csr_header_t *) mapped_file;
+  *     const uint64_t * offsets = (const uint64_t *) (mapped_file + header->offsets_position);
+  *     const uint32_t * entries = (const uint32_t *) (mapped_file + header->entries_position);
+  */
+//@{
+/// Content of a CSR file.
+enum csr_kind_t {
+  /// Rows are nodes, entries are their neighbours (every edge appears in the rows of its two nodes).
+  CSR_EDGE_LIST = 1,
+  /// Same as CSR_EDGE_LIST, assuming complete connectivity of the communities.
+  CSR_CONNECTED_EDGE_LIST = 2,
+  /// Rows are clusters, entries are the nodes that belong to them.
+  CSR_CLUSTER_CONTENTS = 3,
+  /// Rows are nodes, entries are the clusters to which they belong.
+  CSR_NODE_PARTICIPATIONS = 4
+};
+/// Header of a CSR file (64 bytes).
+struct csr_header_t {
+  /// "SPA-CSR" followed by a null character.
+  char magic[8];
+  /// Version of the layout (csr_version).
+  uint32_t version;
+  /// csr_byte_order, as written by the machine that wrote the file.
+  uint32_t byte_order;
+  /// Content of the file (csr_kind_t).
+  uint32_t kind;
+  /// Size of an entry, in bytes.
+  uint32_t entry_size;
+  /// Number of rows.
+  uint64_t rows;
+  /// Number of entries.
+  uint64_t entries;
+  /// Number of distinct entry values (nodes or clusters), i.e. entries are in [0, columns).
+  uint64_t columns;
+  /// Position of the offsets in the file, in bytes.
+  uint64_t offsets_position;
+  /// Position of the entries in the file, in bytes.
+  uint64_t entries_position;
+};
+const uint32_t csr_version = 1;
+const uint32_t csr_byte_order = 0x01020304;
+//@}
+
+/** @name Format selection */
+//@{
+/** True if @p format is the name of an output format ("text", "binary" or "compressed"). */
+bool is_valid_format_name(const std::string & format);
+/** True if the output at @p path is written in binary, i.e. if the path ends with ".csr"
+  * or if @p format is "binary" (only outputs with a CSR layout, never the stdout).
+  */
+bool is_binary_output(const std::string & path, const std::string & format);
+/** True if one or more output is written in binary (CSR layout or compressed edge list). */
+bool binary_output_requested(const spa_parameters_t & param);
+//@}
+
+/** @name Binary outputs
+  * @remark The streams must be opened in binary mode, and cannot be appended to.
+  */
+//@{
+/** Symmetric adjacency of an edge list.
+  * @param[in] <nodes> Number of nodes of the network (rows).
+  * @param[in] <edge_list> Sorted edge list.
+  * @param[in] <kind> CSR_EDGE_LIST or CSR_CONNECTED_EDGE_LIST.
+  */
+void output_csr_edge_list(size_t nodes, const edge_list_t & edge_list, csr_kind_t kind, std::ostream& os);
+void output_csr_cluster_contents(const spa_network_t & network, std::ostream& os);
+void output_csr_node_participations(const spa_network_t & network, std::ostream& os);
+//@}
+
+#endif //BINARY_OUTPUT_HPP
@@ -0,0 +1,86 @@
+#include "compressed_edge_list.hpp"
+
+// C libraries
+#include <string.h> // memset, memcpy
+// STL
+#include <vector> // blocks and index
+
+// Helpers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace {
+  /// Extension of the paths that are always compressed.
+  const std::string compressed_extension = ".dvz";
+  /// Extension of the paths that are always written in the CSR layout (see binary_output.hpp).
+  const std::string csr_extension = ".csr";
+
+  bool ends_with(const std::string & path, const std::string & extension) {
+    return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+  }
+  /** Append the LEB128 varint of @p value to the block. */
+  void put_varint(uint32_t value, std::vector<uint8_t> & block) {
+    while (value >= 0x80) {
+      block.push_back((uint8_t) (value | 0x80));
+      value >>= 7;
+    }
+    block.push_back((uint8_t) value);
+    return;
+  }
+}
+
+// ============================================================================================
+// PUBLIC =====================================================================================
+// ============================================================================================
+
+bool is_compressed_output(const std::string & path, const std::string & format) {
+  if (path.empty()) return false; // stdout
+  if (ends_with(path, compressed_extension)) return true;
+  return format == "compressed" && !ends_with(path, csr_extension);
+}
+void output_compressed_edge_list(const edge_list_t & edge_list, std::ostream& os) {
+  compressed_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "SPA-DVE", 8);
+  header.version = compressed_version;
+  header.byte_order = compressed_byte_order;
+  header.block_edges = compressed_block_edges;
+  header.edges = edge_list.size();
+  os.write((const char *) &header, sizeof(header));
+
+  std::vector<compressed_block_t> index;
+  index.reserve((edge_list.size() + compressed_block_edges - 1) / compressed_block_edges);
+  std::vector<uint8_t> block;
+  // at most 2 varints of 5 bytes per edge
+  block.reserve(10 * (size_t) compressed_block_edges);
+  uint64_t position = sizeof(header);
+  uint32_t in_block = 0;
+  id_t previous_u = 0, previous_v = 0;
+  for (auto it = edge_list.begin(); it != edge_list.end(); ++it) {
+    const id_t u = it->first, v = it->second;
+    if (in_block == 0) {
+      compressed_block_t entry = {position, u, v};
+      index.push_back(entry);
+      put_varint(u, block);
+      put_varint(v - u - 1, block);
+    }
+    else {
+      put_varint(u - previous_u, block);
+      put_varint(u == previous_u ? v - previous_v - 1 : v - u - 1, block);
+    }
+    previous_u = u;
+    previous_v = v;
+    if (++in_block == compressed_block_edges) {
+      os.write((const char *) block.data(), block.size());
+      position += block.size();
+      block.clear();
+      in_block = 0;
+    }
+  }
+  if (in_block > 0) {
+    os.write((const char *) block.data(), block.size());
+    position += block.size();
+  }
+
+  compressed_trailer_t trailer = {position, index.size()};
+  os.write((const char *) index.data(), index.size() * sizeof(compressed_block_t));
+  os.write((const char *) &trailer, sizeof(trailer));
+  return;
+}
@@ -0,0 +1,84 @@
+#ifndef COMPRESSED_EDGE_LIST_HPP
+#define COMPRESSED_EDGE_LIST_HPP
+/**
+  * @file compressed_edge_list.hpp
+  * @brief Compressed edge lists: delta-coded, varint-packed edges, by blocks with an index.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <stdint.h> // fixed width fields of the files
+// STL
+#include <iostream> // ostream
+#include <string>   // paths and format names
+// Project files
+#include "edge_list.hpp" // edge_list_t
+
+/** @name Compressed edge list files
+  * A compressed edge list file is streamed in four parts, in the byte order of the
+  * machine that wrote it (see utilities/decompress_edges.cpp for a decoder):
+  *
+  *     [compressed_header_t][block 0][block 1]...[index][compressed_trailer_t]
+  *
+  * Each block holds block_edges consecutive edges (u, v) of the sorted list (fewer
+  * for the last one), with u < v, as pairs of LEB128 varints (7 bits per byte, least
+  * significant group first, high bit set on every byte but the last):
+  *   - first edge of the block: u, then v - u - 1;
+  *   - next edges: u - u', then v - v' - 1 if u = u' or v - u - 1 otherwise, where
+  *     (u', v') is the previous edge.
+  * The index has an entry (compressed_block_t) per block, such that a reader can seek
+  * the block of any edge, or the first block that may contain the edges of a node.
+  */
+//@{
+/// Header of a compressed edge list file (32 bytes).
+struct compressed_header_t {
+  /// "SPA-DVE" followed by a null character.
+  char magic[8];
+  /// Version of the layout (compressed_version).
+  uint32_t version;
+  /// compressed_byte_order, as written by the machine that wrote the file.
+  uint32_t byte_order;
+  /// Number of edges of a block (all blocks but the last one).
+  uint32_t block_edges;
+  uint32_t reserved;
+  /// Number of edges.
+  uint64_t edges;
+};
+/// Index entry of a block (16 bytes).
+struct compressed_block_t {
+  /// Position of the block in the file, in bytes.
+  uint64_t position;
+  /// First edge of the block.
+  uint32_t first_u;
+  uint32_t first_v;
+};
+/// Trailer of a compressed edge list file (16 bytes), i.e. its last bytes.
+struct compressed_trailer_t {
+  /// Position of the index in the file, in bytes.
+  uint64_t index_position;
+  /// Number of blocks.
+  uint64_t blocks;
+};
+// the layout is part of the format (see utilities/decompress_edges.cpp, which has its own copies)
+static_assert(sizeof(compressed_header_t) == 32, "compressed_header_t must be 32 bytes.");
+static_assert(sizeof(compressed_block_t) == 16, "compressed_block_t must be 16 bytes.");
+static_assert(sizeof(compressed_trailer_t) == 16, "compressed_trailer_t must be 16 bytes.");
+const uint32_t compressed_version = 1;
+const uint32_t compressed_byte_order = 0x01020304;
+const uint32_t compressed_block_edges = 1 << 16;
+//@}
+
+/** True if the edge list at @p path is compressed, i.e. if the path ends with ".dvz", or if
+  * @p format is "compressed" and the path does not end with ".csr" (never the stdout).
+  */
+bool is_compressed_output(const std::string & path, const std::string & format);
+/** Write a sorted edge list in the compressed format.
+  * @remark The stream must be opened in binary mode, and cannot be appended to.
+  */
+void output_compressed_edge_list(const edge_list_t & edge_list, std::ostream& os);
+
+#endif //COMPRESSED_EDGE_LIST_HPP
@@ -1,4 +1,8 @@
-// Default configs
+#if HAVE_CMAKE_CONFIG == 1
+// Configuration generated by CMake from config.h.in (see the options of CMakeLists.txt).
+#include "spa_config.h"
+#else
+// Default configs, for a direct compilation (edit the values below to change them)
 
 // boost::program_options: Set to 0 if libboostprogram options is not present
 #define HAVE_LIBBOOST_PROGRAM_OPTIONS 1
@@ -16,6 +20,17 @@
 // Reduce memory footprint at the cost of speed. Set to 1 to enable the tradeoff.
 #define MEMORY_OPTIMIZED 0
 
+// Preferential sampler backend: goes from 0 to 2.
+//  0: LINEAR (legacy linear scan over the tickets: O(1) update, O(n) pick)
+//  1: FENWICK (binary indexed tree: O(log n) update and pick, same picks as LINEAR)
+//  2: URN (one entry per ticket: O(1) update and pick, different picks for a given seed)
+#define PREFERENTIAL_SAMPLER 1
+
+// Link target selection: set to 1 to pick the targets of link creation steps by rejection
+// sampling (O(1) expected draws, different picks for a given seed), instead of enumerating
+// the non-neighbors of the link creating node (O(degree)).
+#define LINK_REJECTION_SAMPLING 0
+
 // Compile assertations out. Should improve performance when branch prediction is poor.
 #define REMOVE_ASSERTS 1
 
@@ -23,3 +38,4 @@
 #if REMOVE_ASSERTS == 1
     #define NDEBUG 1
 #endif
+#endif
@@ -0,0 +1,145 @@
+#ifndef DRAW_BUFFER_HPP
+#define DRAW_BUFFER_HPP
+/**
+  * @file draw_buffer.hpp
+  * @brief Buffered integer and Bernoulli draws shared by all the random picks of the SPA process.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <assert.h> // error checking: turn off with #define NDEBUG
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+#include <math.h>   // floor, ceil
+// STL
+#include <random>      // std::uniform_real_distribution (reference arithmetic)
+#include <type_traits> // std::is_same
+// Project files
+#include "rng_engines.hpp" // engine types, uint128_t
+
+/*  Every random decision of the process goes through a single draw_buffer_t,
+ *  which pulls the raw outputs of the engine in blocks of @p block_size words.
+ *  The first blocks are smaller (doubling from @p first_block_size), such that
+ *  short-lived buffers, e.g. one per community, do not draw words they never use.
+ *
+ *  The draws are computed with integer arithmetic: bounded integers with
+ *  Lemire's multiply-and-reject method (exact, one multiplication and almost
+ *  never a division) and Bernoulli tests against 53-bit fixed-point thresholds.
+ *
+ *  std::mt19937 keeps the floating point arithmetic of the previous versions
+ *  (floor / ceil of a uniform double), so that it still reproduces the same
+ *  networks for a given seed. The words are consumed in the same order, the
+ *  buffering itself does not change the sequence.
+ */
+
+/** @class probability_t
+  * @brief Probability of a Bernoulli test, with its 53-bit fixed-point representation.
+  */
+struct probability_t {
+  /// Probability (double precision).
+  double value;
+  /// Fixed-point threshold: a 53-bit uniform integer u succeeds if u < fixed, i.e. with probability value.
+  uint64_t fixed;
+  explicit probability_t(double p) : value(p) {
+    const double scale = 9007199254740992.0; // 2^53
+    if (p <= 0) fixed = 0;
+    else if (p >= 1) fixed = (uint64_t) 1 << 53;
+    else fixed = (uint64_t) ceil(p * scale);
+  }
+};
+
+/// Engines that keep the arithmetic of the previous versions (reproducibility).
+template <typename engine_t> struct reference_arithmetic : std::is_same<engine_t, std::mt19937> { };
+
+/** @class draw_buffer_t
+  * @brief Block-refilled source of bounded integers and Bernoulli tests.
+  *
+  * Also satisfies the UniformRandomBitGenerator requirements (same range as the
+  * engine), such that standard distributions can draw from the same buffer.
+  * @warning The engine must not be used directly while the buffer is alive.
+  */
+template <typename engine_t>
+class draw_buffer_t {
+public:
+  typedef typename engine_t::result_type result_type;
+  static constexpr result_type min() {return engine_t::min();}
+  static constexpr result_type max() {return engine_t::max();}
+  /// Number of words pulled from the engine at once.
+  static const size_t block_size = 256;
+  /// Size of the first block.
+  static const size_t first_block_size = 4;
+
+  static_assert(reference_arithmetic<engine_t>::value ||
+                (engine_t::min() == 0 && engine_t::max() == UINT64_MAX),
+                "the integer draws expect 64 bits words.");
+
+  explicit draw_buffer_t(engine_t & engine) : engine_(engine), next_(0), end_(0), rand_real_(0,1) { }
+
+  /// Next raw word of the engine.
+  result_type operator()() {
+    if (next_ == end_) refill();
+    return words_[next_++];
+  }
+
+  /** Uniform integer in [0, upper_bound[.
+    * @remark Complexity: one 64x64 bits multiplication, plus a division in n / 2^64 of the calls.
+    */
+  uint64_t bounded(uint64_t upper_bound) {
+    assert(upper_bound > 0);
+    if (reference_arithmetic<engine_t>::value) return (uint64_t) floor(rand_real_(*this) * (double) upper_bound);
+    uint128_t product = (uint128_t) (*this)() * upper_bound;
+    uint64_t low = (uint64_t) product;
+    if (low < upper_bound) {
+      const uint64_t threshold = (0 - upper_bound) % upper_bound;
+      while (low < threshold) {
+        product = (uint128_t) (*this)() * upper_bound;
+        low = (uint64_t) product;
+      }
+    }
+    return (uint64_t) (product >> 64);
+  }
+
+  /** Uniform ticket in [1, total] (1-based, see preferential_samplers.hpp). */
+  uint64_t ticket(uint64_t total) {
+    assert(total > 0);
+    if (reference_arithmetic<engine_t>::value) {
+      uint64_t ticket = (uint64_t) ceil(rand_real_(*this) * (double) total);
+      // rand_real_ can return exactly 0, in which case the first ticket is drawn.
+      return ticket == 0 ? 1 : ticket;
+    }
+    return bounded(total) + 1;
+  }
+
+  /** True with probability @p p. */
+  bool bernoulli(const probability_t & p) {
+    if (reference_arithmetic<engine_t>::value) return rand_real_(*this) < p.value;
+    return unit() < p.fixed;
+  }
+
+  /** Uniform integer in [0, 2^53[, i.e. a uniform in [0,1[ in 53-bit fixed point (see probability_t).
+    * @remark 64 bits engines only (see the static assertion): the reference engine draws from rand_real_.
+    */
+  uint64_t unit() {return (uint64_t) (*this)() >> 11;}
+
+private:
+  void refill() {
+    end_ = end_ == 0 ? first_block_size : (end_ < block_size ? 2 * end_ : block_size);
+    for (size_t i = 0; i < end_; ++i) words_[i] = engine_();
+    next_ = 0;
+  }
+
+  /// Source of the words.
+  engine_t & engine_;
+  /// Words that were drawn but not consumed yet: words_[next_] to words_[end_ - 1].
+  result_type words_[block_size];
+  size_t next_;
+  size_t end_;
+  /// Reference arithmetic (std::mt19937).
+  std::uniform_real_distribution<double> rand_real_;
+};
+
+#endif //DRAW_BUFFER_HPP
@@ -0,0 +1,125 @@
+#include "edge_list.hpp"
+
+// STL
+#include <algorithm> // std::sort, std::unique, std::lower_bound, std::min, std::max
+#include <thread>    // std::thread (radix sort)
+
+// Radix sort ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace {
+  /// Digits of 16 bits: at most 4 passes over 64-bit keys, and histograms that fit in the L2 cache.
+  const unsigned int digit_bits = 16;
+  const size_t buckets = (size_t) 1 << digit_bits;
+  /// Below this size, std::sort beats the histograms of the radix sort.
+  const size_t radix_sort_threshold = (size_t) 1 << 16;
+  /// Keys of each thread, at least.
+  const size_t keys_per_thread = (size_t) 1 << 18;
+  /// Size of the buffer below which edges are never compacted.
+  const size_t minimal_compaction_size = (size_t) 1 << 22;
+
+  /// Run function(t) for t in [0, threads), the calling thread taking t = 0.
+  template <typename function_t>
+  void run_parallel(unsigned int threads, function_t function) {
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; ++t) pool.emplace_back(function, t);
+    function(0);
+    for (auto it = pool.begin(); it != pool.end(); ++it) it->join();
+    return;
+  }
+  /** Stable LSD radix sort. Each thread histograms, then scatters, a contiguous chunk
+    * of the keys; the digits that are the same for every key are skipped.
+    */
+  void radix_sort(std::vector<uint64_t> & keys, unsigned int threads) {
+    const size_t n = keys.size();
+    if (n < radix_sort_threshold) {
+      std::sort(keys.begin(), keys.end());
+      return;
+    }
+    threads = (unsigned int) std::max((size_t) 1, std::min((size_t) threads, n / keys_per_thread));
+    uint64_t varying = 0;
+    for (size_t i = 0; i < n; ++i) varying |= keys[i] ^ keys[0];
+    std::vector<uint64_t> buffer(n);
+    std::vector<size_t> counts(threads * buckets);
+    auto chunk_begin = [n, threads](unsigned int t) {return n * t / threads;};
+    for (unsigned int shift = 0; shift < 64; shift += digit_bits) {
+      if (((varying >> shift) & (buckets - 1)) == 0) continue;
+      std::fill(counts.begin(), counts.end(), 0);
+      run_parallel(threads, [&](unsigned int t) {
+        size_t * count = counts.data() + t * buckets;
+        for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i) ++count[(keys[i] >> shift) & (buckets - 1)];
+      });
+      // positions by digit, then by thread: the keys of a digit keep their order
+      size_t position = 0;
+      for (size_t digit = 0; digit < buckets; ++digit) {
+        for (unsigned int t = 0; t < threads; ++t) {
+          const size_t count = counts[t * buckets + digit];
+          counts[t * buckets + digit] = position;
+          position += count;
+        }
+      }
+      run_parallel(threads, [&](unsigned int t) {
+        size_t * next = counts.data() + t * buckets;
+        for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i) buffer[next[(keys[i] >> shift) & (buckets - 1)]++] = keys[i];
+      });
+      keys.swap(buffer);
+    }
+    return;
+  }
+}
+
+// ============================================================================================
+// PUBLIC =====================================================================================
+// ============================================================================================
+
+edge_list_t::edge_list_t(unsigned int threads) : threads_(threads), compaction_size_(minimal_compaction_size) {
+  if (threads_ == 0) threads_ = std::max(1u, std::thread::hardware_concurrency());
+}
+void edge_list_t::sort_unique() {
+  compact();
+  return;
+}
+void edge_list_t::clear() {
+  std::vector<uint64_t>().swap(keys_);
+  compaction_size_ = minimal_compaction_size;
+  return;
+}
+void edge_list_t::merge(std::vector<edge_list_t> & parts) {
+  clear();
+  if (parts.size() == 1) keys_.swap(parts[0].keys_);
+  else if (!parts.empty()) {
+    std::vector<size_t> offsets(parts.size() + 1, 0);
+    for (size_t part = 0; part < parts.size(); ++part) offsets[part + 1] = offsets[part] + parts[part].keys_.size();
+    keys_.resize(offsets.back());
+    // one thread per part
+    run_parallel((unsigned int) parts.size(), [&](unsigned int part) {
+      std::copy(parts[part].keys_.begin(), parts[part].keys_.end(), keys_.begin() + offsets[part]);
+      parts[part].clear();
+    });
+  }
+  compact();
+  return;
+}
+edge_list_t::const_iterator edge_list_t::begin() const {return const_iterator(keys_.data());}
+edge_list_t::const_iterator edge_list_t::end() const {return const_iterator(keys_.data() + keys_.size());}
+size_t edge_list_t::size() const {return keys_.size();}
+bool edge_list_t::empty() const {return keys_.empty();}
+unsigned int edge_list_t::threads() const {return threads_;}
+edge_list_t::const_iterator edge_list_t::find(const edge_t & edge) const {
+  const uint64_t key = pack(edge.first, edge.second);
+  auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+  if (it == keys_.end() || *it != key) return end();
+  return const_iterator(keys_.data() + (it - keys_.begin()));
+}
+
+// ============================================================================================
+// PRIVATE ====================================================================================
+// ============================================================================================
+
+void edge_list_t::compact() {
+  const size_t appended = keys_.size();
+  radix_sort(keys_, threads_);
+  keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+  // few duplicates: compactions would not save memory, sort once at the end
+  if (keys_.size() > appended / 4 * 3) compaction_size_ = (size_t) -1;
+  else compaction_size_ = std::max(2 * keys_.size(), minimal_compaction_size);
+  return;
+}
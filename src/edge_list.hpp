@@ -0,0 +1,119 @@
+#ifndef EDGE_LIST_HPP
+#define EDGE_LIST_HPP
+/**
+  * @file edge_list.hpp
+  * @brief Sorted list of unique edges, packed in 64-bit keys.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <stdint.h> // uint64_t
+#include <stddef.h> // size_t
+// STL
+#include <vector>   // keys
+#include <iterator> // std::input_iterator_tag
+// Typdef and helpers
+#include "types.hpp" // id_t, edge_t
+
+/** @class edge_list_t
+  * @brief Edges (u, v) with u < v, stored as the keys (u << 32 | v) of a flat buffer.
+  *
+  *  Edges are first appended, duplicates included, then sorted and deduplicated
+  *  by sort_unique(0), with a (parallel) radix sort. The order of the keys is the
+  *  lexicographic order of the edges, i.e. the order of a std::set<edge_t>. While
+  *  edges are appended, the buffer is compacted whenever it doubles, such that
+  *  heavily duplicated inputs do not need much more memory than their unique edges.
+  */
+class edge_list_t {
+public:
+  /** @class const_iterator
+    * @brief Read-only iterator over the edges, which are unpacked on the fly.
+    *
+    *  Dereferencing returns the edge by value, hence the iterator is only an input
+    *  iterator for the standard algorithms; += and - still jump and measure in O(1).
+    */
+  class const_iterator {
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef edge_t value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const edge_t * pointer;
+    typedef edge_t reference;
+    /// Unpacked edge, for it->first and it->second.
+    struct arrow_t {
+      edge_t edge;
+      const edge_t * operator->() const {return &edge;}
+    };
+
+    const_iterator() : key_(nullptr) {}
+    explicit const_iterator(const uint64_t * key) : key_(key) {}
+    edge_t operator*() const {return unpack(*key_);}
+    arrow_t operator->() const {arrow_t arrow = {unpack(*key_)}; return arrow;}
+    const_iterator & operator++() {++key_; return *this;}
+    const_iterator operator++(int) {const_iterator copy(*this); ++key_; return copy;}
+    const_iterator & operator+=(difference_type n) {key_ += n; return *this;}
+    difference_type operator-(const const_iterator & rhs) const {return key_ - rhs.key_;}
+    bool operator==(const const_iterator & rhs) const {return key_ == rhs.key_;}
+    bool operator!=(const const_iterator & rhs) const {return key_ != rhs.key_;}
+
+  private:
+    const uint64_t * key_;
+  };
+
+  /** @param[in] <threads> Number of threads of the radix sorts (0: one per core). */
+  explicit edge_list_t(unsigned int threads = 1);
+
+  /** @name Construction */
+  //@{
+  /** Append the edge (u, v), with u < v. Duplicates are allowed until sort_unique(0). */
+  void push_back(id_t u, id_t v);
+  /** Sort the keys and remove the duplicates. */
+  void sort_unique();
+  /** Remove every edge and release the memory. */
+  void clear();
+  /** Replace the edges by the sorted union of other lists, each released once
+    * copied. The result does not depend on how the edges are spread among them.
+    */
+  void merge(std::vector<edge_list_t> & parts);
+  //@}
+
+  /** @name Accessors (sorted list only) */
+  //@{
+  const_iterator begin() const;
+  const_iterator end() const;
+  size_t size() const;
+  bool empty() const;
+  /** Number of threads of the radix sorts. */
+  unsigned int threads() const;
+  /** Binary search of the edge (u, v), with u < v. */
+  const_iterator find(const edge_t & edge) const;
+  //@}
+
+  /** @name Packing */
+  //@{
+  static uint64_t pack(id_t u, id_t v) {return (uint64_t) u << 32 | v;}
+  static edge_t unpack(uint64_t key) {return edge_t((id_t) (key >> 32), (id_t) (key & 0xFFFFFFFFu));}
+  //@}
+
+private:
+  /** Sort and deduplicate the keys that were appended so far. */
+  void compact();
+
+  std::vector<uint64_t> keys_;
+  unsigned int threads_;
+  /// Size of the buffer that triggers the next compaction (see push_back(2)).
+  size_t compaction_size_;
+};
+
+// Appending is defined inline: it is called once per link of every subgraph.
+inline void edge_list_t::push_back(id_t u, id_t v) {
+  if (keys_.size() == compaction_size_) compact();
+  keys_.push_back(pack(u, v));
+  return;
+}
+
+#endif //EDGE_LIST_HPP
@@ -0,0 +1,77 @@
+#include "incidence_list.hpp"
+
+// STL
+#include <algorithm> // std::upper_bound, std::equal_range, std::copy, std::copy_backward
+
+// ============================================================================================
+// PUBLIC =====================================================================================
+// ============================================================================================
+
+// CTOR
+incidence_list_t::incidence_list_t() : size_(0), capacity_(inline_capacity) { }
+incidence_list_t::incidence_list_t(incidence_list_t && other) noexcept : size_(other.size_), capacity_(other.capacity_) {
+  if (other.is_inline()) std::copy(other.inline_, other.inline_ + other.size_, inline_);
+  else heap_ = other.heap_;
+  other.size_ = 0;
+  other.capacity_ = inline_capacity;
+}
+incidence_list_t & incidence_list_t::operator=(incidence_list_t && other) noexcept {
+  if (this != &other) {
+    // no arena at hand: the previous heap storage is reclaimed when the arena is released.
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    if (other.is_inline()) std::copy(other.inline_, other.inline_ + other.size_, inline_);
+    else heap_ = other.heap_;
+    other.size_ = 0;
+    other.capacity_ = inline_capacity;
+  }
+  return *this;
+}
+
+// CAPACITY
+void incidence_list_t::reserve(size_t capacity, arena_t & arena) {
+  if (capacity <= capacity_) return;
+  id_t * storage = static_cast<id_t*>(arena.allocate(capacity * sizeof(id_t)));
+  std::copy(begin(), end(), storage);
+  release(arena);
+  heap_ = storage;
+  capacity_ = (uint32_t) capacity;
+}
+
+// ACCESSORS
+size_t incidence_list_t::count(id_t id) const {
+  auto range = std::equal_range(begin(), end(), id);
+  return range.second - range.first;
+}
+
+// MODIFIERS
+void incidence_list_t::insert(id_t id, arena_t & arena) {
+  if (size_ == capacity_) reserve(2 * (size_t) capacity_, arena);
+  id_t * first = data();
+  // new elements are often the largest identifiers: check the back before searching.
+  id_t * position = (size_ == 0 || first[size_-1] <= id) ? first + size_ : std::upper_bound(first, first + size_, id);
+  std::copy_backward(position, first + size_, first + size_ + 1);
+  *position = id;
+  ++size_;
+}
+size_t incidence_list_t::erase(id_t id) {
+  id_t * first = data();
+  auto range = std::equal_range(first, first + size_, id);
+  size_t erased = range.second - range.first;
+  std::copy(range.second, first + size_, range.first);
+  size_ -= (uint32_t) erased;
+  return erased;
+}
+void incidence_list_t::clear(arena_t & arena) {
+  release(arena);
+  size_ = 0;
+}
+
+// ============================================================================================
+// PRIVATE ====================================================================================
+// ============================================================================================
+
+void incidence_list_t::release(arena_t & arena) {
+  if (!is_inline()) arena.deallocate(heap_, capacity_ * sizeof(id_t));
+  capacity_ = inline_capacity;
+}
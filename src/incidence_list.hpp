@@ -0,0 +1,117 @@
+#ifndef INCIDENCE_LIST_HPP
+#define INCIDENCE_LIST_HPP
+/**
+  * @file incidence_list.hpp
+  * @brief Compact sorted multiset of identifiers (one row of an incidence matrix).
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <assert.h> // error checking: turn off with #define NDEBUG
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t, uintptr_t
+// Project files
+#include "arena.hpp" // arena_t (storage of long lists)
+// Typdef and helpers
+#include "types.hpp" // id_t
+
+/** @class incidence_list_t
+  * @brief Compact sorted multiset of identifiers.
+  *
+  *  @p incidence_list_t stores the identifiers of a row of the incidence matrix
+  *  (participations of a node or content of a cluster) in a single contiguous,
+  *  sorted array. Duplicates are allowed and iteration yields the identifiers in
+  *  the same order as a std::multiset<id_t>.
+  *
+  *  Short lists (up to @p inline_capacity identifiers) are stored inside the object
+  *  itself, such that the most common rows (nodes with one or two memberships) do
+  *  not require any heap allocation. The object is 16 bytes large, compared to 48
+  *  bytes plus 40 bytes per element for a std::multiset.
+  *
+  *  Longer lists are stored in an arena_t, passed to every member function that
+  *  may allocate or free memory. The arena owns that memory: lists are trivially
+  *  destructible, such that destroying a vector of lists costs nothing, and the 
+  *  storage is reclaimed in bulk when the arena is released.
+  *
+  *  @remark Complexity: insertion is O(log n) to locate the element and O(n) to shift
+  *          the tail (a memmove), iteration is a linear scan of contiguous memory.
+  *  @warning Lists cannot be copied, and the arena must outlive the list.
+  */
+class incidence_list_t {
+public:
+  typedef const id_t* const_iterator;
+  /// Number of identifiers that are stored without heap allocation.
+  static const size_t inline_capacity = sizeof(uintptr_t) / sizeof(id_t);
+
+  /** @name Constructor */
+  //@{
+  incidence_list_t();
+  incidence_list_t(incidence_list_t && other) noexcept;
+  incidence_list_t & operator=(incidence_list_t && other) noexcept;
+  //@}
+
+  /** @name Capacity */
+  //@{
+  size_t size() const;
+  bool empty() const;
+  void reserve(size_t capacity, arena_t & arena);
+  //@}
+
+  /** @name Accessors */
+  //@{
+  const_iterator begin() const;
+  const_iterator end() const;
+  /** Number of occurrences of an identifier. Complexity: O(log n). */
+  size_t count(id_t id) const;
+  //@}
+
+  /** @name Modifiers */
+  //@{
+  /** Insert an identifier, after its existing occurrences (std::multiset semantic). */
+  void insert(id_t id, arena_t & arena);
+  /** Remove every occurrence of an identifier.
+    * @return The number of removed elements.
+    */
+  size_t erase(id_t id);
+  /** Remove every element and give the storage back to the arena. */
+  void clear(arena_t & arena);
+  //@}
+
+private:
+  incidence_list_t(const incidence_list_t &);
+  incidence_list_t & operator=(const incidence_list_t &);
+
+  bool is_inline() const;
+  id_t * data();
+  const id_t * data() const;
+  void release(arena_t & arena);
+
+  /** @name Private data members */
+  //@{
+  union {
+    /// Storage of short lists.
+    id_t inline_[inline_capacity];
+    /// Storage of long lists (in the arena).
+    id_t * heap_;
+  };
+  /// Number of elements.
+  uint32_t size_;
+  /// Number of elements that fit in the current storage.
+  uint32_t capacity_;
+  //@}
+};
+
+// Trivial accessors are defined inline: they are called in every loop over the incidence matrix.
+inline size_t incidence_list_t::size() const {return size_;}
+inline bool incidence_list_t::empty() const {return size_ == 0;}
+inline incidence_list_t::const_iterator incidence_list_t::begin() const {return data();}
+inline incidence_list_t::const_iterator incidence_list_t::end() const {return data() + size_;}
+inline bool incidence_list_t::is_inline() const {return capacity_ == inline_capacity;}
+inline id_t * incidence_list_t::data() {return is_inline() ? inline_ : heap_;}
+inline const id_t * incidence_list_t::data() const {return is_inline() ? inline_ : heap_;}
+
+#endif //INCIDENCE_LIST_HPP
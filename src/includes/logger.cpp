@@ -48,6 +48,7 @@ void Logger::Write(Priority priority, const std::string& message)
         // identify current output stream
         std::ostream& stream
             = instance.fileStream.is_open() ? instance.fileStream : std::clog;
+        std::lock_guard<std::mutex> lock(instance.mutex);
  
         stream  << PRIORITY_NAMES[priority]
                 << ": "
@@ -9,6 +9,7 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 
   /** @class Logger
   * @brief Logger class to write messages
@@ -47,6 +48,8 @@ private:
     bool            active;
     std::ofstream   fileStream;
     Priority        minPriority;
+    // messages of concurrent realizations are written one at a time
+    std::mutex      mutex;
  
     // names describing the items in enum Priority
     static const std::string PRIORITY_NAMES[];
@@ -14,7 +14,7 @@ int boost_interface(int argc, const char *argv[], spa_parameters_t & param) {
   ("q,q",po::value<double>(&param.q.value),"Probability that a node is a new one, for growth and birth events.")
   ("r,r",po::value<double>(&param.r.value),"Ratio of the internal link creation and recruiting rates.\n\n")
   ("final_size,N",po::value<unsigned int>(&param.final_size.value),"Final size of the network, in nodes).")
-  ("seed,d",po::value<unsigned int>(&param.seed.value),"Seed of the pseudo random number generator (Mersenne-twister 19937).\n\n")
+  ("seed,d",po::value<unsigned int>(&param.seed.value),"Seed of the pseudo random number generator (see engine).\n\n")
   //Output files~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   ("edge_list,E",po::value<std::string>(&param.edge_list.value),"Path of the edge list file (output).\n If set to \"\", redirect the output to stdout.\n Each line contains the identifiers of 2 nodes that are related by an undirected, unweighted link.")
   ("connected_edge_list,Z",po::value<std::string>(&param.connected_edge_list.value),"Path of the connected edge list file (output).\n If set to \"\", redirect the output to stdout.\n Each line contains the identifiers of 2 nodes that are related by an undirected, unweighted link, assuming that each cluster is fully connected.")
@@ -33,7 +33,17 @@ int boost_interface(int argc, const char *argv[], spa_parameters_t & param) {
   ("minimal_size,m",po::value<unsigned int>(&param.minimal_size.value),"Smallest communities threshold. Communities bellow that threshold are removed before processing the output. This parameter is useful if one wishes to model a modular structure that was detected by an algorithms that imposes a minimum resolution, e.g. clique percolation.")
   ("initial_size,n",po::value<unsigned int>(&param.initial_size.value),"Number of communities at time t=0.")
   ("base_path,B",po::value<std::string>(&param.base_path.value),"Base output path (e.g. directory path). Output paths are all relative to this base path.")
-  ("append,a",po::value<bool>(&param.append.value),"Outputs are appended to existing files. Overwriting is the default behavior.\n\n")
+  ("append,a",po::value<bool>(&param.append.value),"Outputs are appended to existing files. Overwriting is the default behavior.")
+  ("format,f",po::value<std::string>(&param.format.value),"Output format: text (default), binary or compressed. Binary outputs (edge lists, cluster contents and node participations) are memory-mappable files in the compressed sparse row layout described in binary_output.hpp: a versioned header, an array of offsets and an array of entries. Compressed edge lists are delta-coded, varint-packed blocks of edges with a block index (see compressed_edge_list.hpp, and utilities/decompress_edges.cpp to convert them back to text); the other outputs are written in text. Paths ending with .csr are always written in binary, paths of edge lists ending with .dvz are always compressed, and the stdout is always written in text.")
+  ("engine,e",po::value<std::string>(&param.engine.value),"Pseudo random number generator: mt19937 (Mersenne-twister 19937, default), xoshiro256pp, pcg64 or philox (counter-based, keyed streams). Only mt19937 reproduces the networks of previous versions for a given seed.")
+  ("deferred_links,x",po::value<bool>(&param.deferred_links.value),"Deferred link handling (complete simulation mode): the communities grow first, and their subgraphs are built afterwards, in parallel. Same distribution as the default mode, but different networks for a given seed.")
+  ("threads,t",po::value<unsigned int>(&param.threads.value),"Number of threads of the parallel steps (0: one per core).")
+  ("relaxed,R",po::value<double>(&param.relaxed.value),"Relaxed-consistency growth, with the given tolerance in ]0,1[ (0: sequential growth, default). The preferential picks are drawn in parallel, by epochs, against the state of the network at the beginning of their epoch. The total variation distance between the law of each pick and its sequential law is at most max(tolerance, basic_size / sum of the community sizes). Draws from philox streams, and implies deferred link handling.")
+  ("validate_relaxed,V",po::value<bool>(&param.validate_relaxed.value),"Validation of the relaxed-consistency growth: a sequential realization is also grown, and the community size, membership and degree distributions of the two realizations are compared with Kolmogorov-Smirnov tests (see the log).")
+  ("realizations,k",po::value<unsigned int>(&param.realizations.value),"Number of realizations (ensemble mode), grown concurrently on the threads (see threads). Realization i draws from the streams of the pair (seed, i), and its outputs are prefixed by \"r<i>_\" in the base path. Outputs do not depend on the number of threads.")
+  ("realization,i",po::value<unsigned int>(&param.realization.value),"Index of the realization (0: default). A single realization with the same seed and --realization=i reproduces the realization i of an ensemble (see realizations).")
+  ("memory_limit,l",po::value<unsigned int>(&param.memory_limit.value),"Memory budget of the concurrent realizations, in MB (0: three quarters of the physical memory, default). Realizations wait until their estimated peak memory fits in the budget.")
+  ("sweep,w",po::value<std::string>(&param.sweep.value),"Parameter sweep over a grid, e.g. \"p=0.1,0.2;q=0.1:0.9:0.2;N=1000:1000000:*10\" (no spaces), where a:b:c is the range from a to b by steps of c, and a:b:*c the range from a to b by factors of c. The swept fields are p, q, r, basic_size (s), final_size (N) and initial_size (n). Every point (and every realization of a point, see realizations) is grown concurrently on the threads, the largest networks first, and its outputs are prefixed by a label such as \"p0.1_q0.5_r1_s1_N1000_n1_\" in the base path. The labels of the completed points are recorded in sweep_manifest.txt in the base path, after the other options (seed, engine, outputs, ...): an interrupted sweep resumes where it stopped, and a sweep with other options refuses to run over it.\n\n")
   //Misc~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   ("config_file,c",po::value<std::string>(&config_file),"If this options is present, program parameters are first read from the specified configuration file, then from the command line. Command line arguments override duplicates in the configuration file. A sample configuration file can be generated in the stdout by executing this program with the --generate_conf_template (or -g) flag.\n\n")
   ("generate_conf_template,g","Generate a configuration file template in the stdout.")
@@ -67,6 +77,16 @@ int boost_interface(int argc, const char *argv[], spa_parameters_t & param) {
   CHECK_OPTION(initial_size)
   CHECK_OPTION(base_path)
   CHECK_OPTION(append)
+  CHECK_OPTION(format)
+  CHECK_OPTION(engine)
+  CHECK_OPTION(deferred_links)
+  CHECK_OPTION(threads)
+  CHECK_OPTION(relaxed)
+  CHECK_OPTION(validate_relaxed)
+  CHECK_OPTION(realizations)
+  CHECK_OPTION(realization)
+  CHECK_OPTION(memory_limit)
+  CHECK_OPTION(sweep)
 
   // Default values. &param.VAR can't be passed directly to po:: because this would mark the variable as initialized,
   // through an erroneous count in CHECK_OPTION (essentially, var_map.count("VAR") will count as defaulted value as 
@@ -76,6 +96,15 @@ int boost_interface(int argc, const char *argv[], spa_parameters_t & param) {
   if (!param.initial_size.initialized)  param.initial_size.value  = 1;
   if (!param.base_path.initialized)     param.base_path.value     = "./";
   if (!param.append.initialized)        param.append.value        = false;
+  if (!param.format.initialized)        param.format.value        = "text";
+  if (!param.engine.initialized)        param.engine.value        = "mt19937";
+  if (!param.deferred_links.initialized) param.deferred_links.value = false;
+  if (!param.threads.initialized)       param.threads.value       = 0;
+  if (!param.relaxed.initialized)       param.relaxed.value       = 0;
+  if (!param.validate_relaxed.initialized) param.validate_relaxed.value = false;
+  if (!param.realizations.initialized)  param.realizations.value  = 1;
+  if (!param.realization.initialized)   param.realization.value   = 0;
+  if (!param.memory_limit.initialized)  param.memory_limit.value  = 0;
 
   // Act on options
   if (argc==1) {
@@ -174,6 +203,15 @@ int parse_config_file(std::string config_file, spa_parameters_t & param) {
   param.initial_size.value  = 1;
   param.base_path.value     = "./";
   param.append.value        = false;
+  param.format.value        = "text";
+  param.engine.value        = "mt19937";
+  param.deferred_links.value = false;
+  param.threads.value       = 0;
+  param.relaxed.value       = 0;
+  param.validate_relaxed.value = false;
+  param.realizations.value  = 1;
+  param.realization.value   = 0;
+  param.memory_limit.value  = 0;
 
   // Variable declarations 
   std::string line_buffer;
@@ -219,6 +257,16 @@ int parse_config_file(std::string config_file, spa_parameters_t & param) {
       PARSE_OPTION(initial_size)
       PARSE_OPTION_STR(base_path)
       PARSE_OPTION_BOOL(append)
+      PARSE_OPTION_STR(format)
+      PARSE_OPTION_STR(engine)
+      PARSE_OPTION_BOOL(deferred_links)
+      PARSE_OPTION(threads)
+      PARSE_OPTION(relaxed)
+      PARSE_OPTION_BOOL(validate_relaxed)
+      PARSE_OPTION(realizations)
+      PARSE_OPTION(realization)
+      PARSE_OPTION(memory_limit)
+      PARSE_OPTION_STR(sweep)
     }
   }
   file.close();
@@ -292,6 +340,15 @@ void generate_template() {
   std::cout << "#       initial_size = 1\n";
   std::cout << "#       base_path = \"./\"\n";
   std::cout << "#       append = false\n";
+  std::cout << "#       format = \"text\"\n";
+  std::cout << "#       engine = \"mt19937\"\n";
+  std::cout << "#       deferred_links = false\n";
+  std::cout << "#       threads = 0\n";
+  std::cout << "#       relaxed = 0\n";
+  std::cout << "#       validate_relaxed = false\n";
+  std::cout << "#       realizations = 1\n";
+  std::cout << "#       realization = 0\n";
+  std::cout << "#       memory_limit = 0\n";
   std::cout << "#================================================================= \n";
   std::cout << "# Structural parameters  {expected format: unsigned integer}.\n";
   std::cout << "basic_size = \n";
@@ -301,11 +358,54 @@ void generate_template() {
   std::cout << "base_path = \n";
   std::cout << "# Options {expected format: boolean}.\n";
   std::cout << "append = \n";
+  std::cout << "# Output format: \"text\", \"binary\" or \"compressed\" (paths ending with .csr are always binary, and with .dvz always compressed) {expected format: string}.\n";
+  std::cout << "format = \n";
+  std::cout << "# Pseudo random number generator: \"mt19937\", \"xoshiro256pp\", \"pcg64\" or \"philox\" {expected format: string}.\n";
+  std::cout << "engine = \n";
+  std::cout << "# Deferred (parallel) link handling {expected format: boolean}.\n";
+  std::cout << "deferred_links = \n";
+  std::cout << "# Number of threads, 0 for one per core {expected format: unsigned integer}.\n";
+  std::cout << "threads = \n";
+  std::cout << "# Relaxed-consistency growth tolerance, 0 for sequential growth {expected format: double}.\n";
+  std::cout << "relaxed = \n";
+  std::cout << "# Validation of the relaxed growth against a sequential realization {expected format: boolean}.\n";
+  std::cout << "validate_relaxed = \n";
+  std::cout << "# Number of realizations (ensemble mode) {expected format: unsigned integer}.\n";
+  std::cout << "realizations = \n";
+  std::cout << "# Index of the realization, 0 by default (reproduces a member of an ensemble) {expected format: unsigned integer}.\n";
+  std::cout << "realization = \n";
+  std::cout << "# Memory budget of the concurrent realizations in MB, 0 for 3/4 of the physical memory {expected format: unsigned integer}.\n";
+  std::cout << "memory_limit = \n";
+  std::cout << "# Parameter sweep, e.g. \"p=0.1,0.2;q=0.1:0.9:0.2;final_size=1000:1000000:*10\" {expected format: string without spaces}.\n";
+  std::cout << "sweep = \n";
   return;
 }
 
 int test_parameters(const spa_parameters_t & param) {
   LOGGER_WRITE(Logger::INFO, "Parameters validation.")
+  if (param.sweep.initialized) {
+    // every point of the grid must be valid
+    std::vector<spa_parameters_t> points;
+    if (!expand_sweep(param.sweep.value, param, points)) return LOGIC_ERROR;
+    if (param.stdout_requested()) {
+      LOGGER_WRITE(Logger::ERROR, "[Logical error] Outputs of a sweep cannot be redirected to the stdout.")
+      return LOGIC_ERROR;
+    }
+    for (auto point = points.begin(); point != points.end(); ++point) {
+      point->sweep.initialized = false;
+      const int point_return = test_parameters(*point);
+      if (point_return != EXIT_SUCCESS) {
+        LOGGER_WRITE(Logger::ERROR, "Invalid sweep point "+VAR_EVAL(point - points.begin())+" (in the order of the specification).")
+        return point_return;
+      }
+    }
+    // a manifest only resumes the sweep that recorded it
+    if (!sweep_manifest_t(sweep_manifest_path(param), sweep_fingerprint(param)).compatible()) {
+      LOGGER_WRITE(Logger::ERROR, "[Logical error] The sweep manifest "+sweep_manifest_path(param)+" was recorded with other options than "+sweep_fingerprint(param)+": remove it, or change the base path.")
+      return LOGIC_ERROR;
+    }
+    return EXIT_SUCCESS;
+  }
   // Test parameters
   try {
     // Missing crucial parameters
@@ -329,6 +429,14 @@ int test_parameters(const spa_parameters_t & param) {
     if (param.q.value < 0 || param.q.value > 1) throw(std::string("[Forbidden value] The node birth probability q must be in the [0,1] interval ("+VAR_PRINT(param.q.value)+")."));
     if (param.r.value < 0 && param.r.initialized==true) throw(std::string("[Forbidden value] The link creation ratio r must be a positive real ("+VAR_PRINT(param.r.value)+")."));
     if (param.final_size.value < param.initial_size.value*param.basic_size.value) throw(std::string("[Forbidden value] The final size must be greater or equal to the initial size ("+VAR_PRINT(param.final_size.value)+", "+VAR_PRINT(param.initial_size.value*param.basic_size.value)+")."));
+    if (param.relaxed.value < 0 || param.relaxed.value >= 1) throw(std::string("[Forbidden value] The relaxed growth tolerance must be in the [0,1[ interval ("+VAR_PRINT(param.relaxed.value)+")."));
+    if (param.validate_relaxed.value && param.relaxed.value == 0) throw(std::string("[Logical error] The validation of the relaxed growth requires a relaxed growth tolerance."));
+    if (param.realizations.value == 0) throw(std::string("[Forbidden value] At least one realization must be requested."));
+    if (param.realizations.value > 1 && param.realization.value > 0) throw(std::string("[Logical error] The index of a realization cannot be set for an ensemble ("+VAR_PRINT(param.realization.value)+")."));
+    if (param.realizations.value > 1 && param.stdout_requested()) throw(std::string("[Logical error] Outputs of several realizations cannot be redirected to the stdout."));
+    if (!is_valid_format_name(param.format.value)) throw(std::string("[Forbidden value] Unknown output format ("+VAR_PRINT(param.format.value)+")."));
+    if (param.append.value && binary_output_requested(param)) throw(std::string("[Logical error] Binary and compressed outputs cannot be appended to existing files."));
+    if (!is_valid_engine_name(param.engine.value)) throw(std::string("[Forbidden value] Unknown pseudo random number generator ("+VAR_PRINT(param.engine.value)+")."));
     if (!param.output_requested()) throw(std::string("[Logical error] No output was requested."));
   }
   catch (const std::string& error_str) {
@@ -362,5 +470,15 @@ void log_parameters(const spa_parameters_t & param) {
   if (param.initial_size.initialized)                 LOGGER_WRITE(Logger::CONFIG, "initial_size: "+VAR_EVAL(param.initial_size.value))
   if (param.base_path.initialized)                    LOGGER_WRITE(Logger::CONFIG, "base_path: "+VAR_EVAL(param.base_path.value))
   if (param.append.initialized)                       LOGGER_WRITE(Logger::CONFIG, "append: "+VAR_EVAL(param.append.value))
+  if (param.format.initialized)                       LOGGER_WRITE(Logger::CONFIG, "format: "+VAR_EVAL(param.format.value))
+  if (param.engine.initialized)                       LOGGER_WRITE(Logger::CONFIG, "engine: "+VAR_EVAL(param.engine.value))
+  if (param.deferred_links.initialized)               LOGGER_WRITE(Logger::CONFIG, "deferred_links: "+VAR_EVAL(param.deferred_links.value))
+  if (param.threads.initialized)                      LOGGER_WRITE(Logger::CONFIG, "threads: "+VAR_EVAL(param.threads.value))
+  if (param.relaxed.initialized)                      LOGGER_WRITE(Logger::CONFIG, "relaxed: "+VAR_EVAL(param.relaxed.value))
+  if (param.validate_relaxed.initialized)             LOGGER_WRITE(Logger::CONFIG, "validate_relaxed: "+VAR_EVAL(param.validate_relaxed.value))
+  if (param.realizations.initialized)                 LOGGER_WRITE(Logger::CONFIG, "realizations: "+VAR_EVAL(param.realizations.value))
+  if (param.realization.initialized)                  LOGGER_WRITE(Logger::CONFIG, "realization: "+VAR_EVAL(param.realization.value))
+  if (param.memory_limit.initialized)                 LOGGER_WRITE(Logger::CONFIG, "memory_limit: "+VAR_EVAL(param.memory_limit.value))
+  if (param.sweep.initialized)                        LOGGER_WRITE(Logger::CONFIG, "sweep: "+VAR_EVAL(param.sweep.value))
   return;
 }
\ No newline at end of file
@@ -10,8 +10,12 @@
 #include <sstream>  // config_file handling
 #include <fstream>  // config_file handling
 #include <string> // config_file handling
+#include <vector> // sweep points
 // Project files
 #include "spa_network.hpp" // spa_network_t
+#include "rng_engines.hpp" // is_valid_engine_name
+#include "sweep.hpp" // expand_sweep(3), sweep_manifest_t, sweep_fingerprint(1)
+#include "binary_output.hpp" // is_valid_format_name, binary_output_requested
 // Typdef and helpers
 #include "types.hpp" // spa_parameters_t, id_t, edge_t
 #include "errors.hpp" // detailed error code 
@@ -1,44 +1,123 @@
 #include "misc_functions.hpp"
 
-void create_edge_list(const spa_network_t & network, std::set<edge_t> & edge_list) {
-  edge_list.clear();
-  for (id_t cluster = 0 ; cluster < network.size_in_clusters(); ++ cluster) {
-    std::multiset< edge_t > subgraph_edges = network.get_subgraph(cluster).get_global_links();
-    for (auto it = subgraph_edges.begin(); it!= subgraph_edges.end(); ++it) {
-      if (it->first != it-> second) edge_list.insert(*it);
-    }
+// STL
+#include <thread> // std::thread (parallel loops over the communities)
+#include <atomic> // std::atomic (next task of the workers)
+
+/// Connected edge lists: pairs of nodes of a task, at least (large communities are split in blocks of rows).
+static const uint64_t pairs_per_task = (uint64_t) 1 << 16;
+/** Number of workers of a parallel loop over @p tasks tasks (at most one per task). */
+static unsigned int workers(size_t tasks, unsigned int threads) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  return (unsigned int) std::max((size_t) 1, std::min((size_t) threads, tasks));
+}
+/** Run function(task, worker) for each task in [0, tasks), on @p threads workers that take the tasks in order. */
+template <typename function_t>
+static void for_each_task(size_t tasks, unsigned int threads, function_t function) {
+  if (threads <= 1) {
+    for (size_t task = 0; task < tasks; ++task) function(task, 0);
+    return;
+  }
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> pool;
+  for (unsigned int t = 0; t < threads; ++t) {
+    pool.emplace_back([&, t]() { for (size_t task = next++; task < tasks; task = next++) function(task, t); });
   }
+  for (auto it = pool.begin(); it != pool.end(); ++it) it->join();
+  return;
+}
+/** Clusters in the order in which the workers take them: the costliest first, such that they do not end up last. */
+template <typename cost_t>
+static std::vector<id_t> cluster_queue(const spa_network_t & network, unsigned int threads, cost_t cost) {
+  std::vector<id_t> queue(network.size_in_clusters());
+  for (id_t cluster = 0; cluster < network.size_in_clusters(); ++cluster) queue[cluster] = cluster;
+  if (threads > 1) std::stable_sort(queue.begin(), queue.end(), [&cost](id_t a, id_t b) {return cost(a) > cost(b);});
+  return queue;
+}
+
+void create_edge_list(const spa_network_t & network, edge_list_t & edge_list) {
+  edge_list.clear();
+  // each worker collects the links of its communities in its own list, merged at the end
+  const unsigned int threads = workers(network.size_in_clusters(), edge_list.threads());
+  const std::vector<id_t> queue = cluster_queue(network, threads, [&network](id_t cluster) {return network.get_subgraph(cluster).size_in_links();});
+  std::vector<edge_list_t> parts(threads);
+  for_each_task(queue.size(), threads, [&](size_t task, unsigned int worker) {
+    const subgraph_t & subgraph = network.get_subgraph(queue[task]);
+    edge_list_t & part = parts[worker];
+    subgraph.for_each_link([&](id_t internal_node1, id_t internal_node2) {
+      id_t node1 = subgraph.get_global_id(internal_node1);
+      id_t node2 = subgraph.get_global_id(internal_node2);
+      if (node1 != node2) part.push_back(std::min(node1,node2), std::max(node1,node2));
+    });
+  });
+  edge_list.merge(parts);
   return;
 }
-void create_connected_edge_list(const spa_network_t & network,  std::set<edge_t> & connected_edge_list) {
+void create_connected_edge_list(const spa_network_t & network,  edge_list_t & connected_edge_list) {
   connected_edge_list.clear();
+  // tasks: blocks of rows [first, last) of the pairs of a community
+  struct rows_t {
+    id_t cluster;
+    uint32_t first;
+    uint32_t last;
+    uint64_t pairs;
+  };
+  const unsigned int threads = workers(network.size_in_clusters(), connected_edge_list.threads());
+  std::vector<rows_t> tasks;
+  tasks.reserve(network.size_in_clusters());
   for (id_t cluster = 0 ; cluster < network.size_in_clusters(); ++ cluster) {
-    subgraph_t subgraph = network.get_subgraph(cluster);
-    subgraph.fully_connect();
-    std::multiset< edge_t > subgraph_edges = subgraph.get_global_links();
-    for (auto it = subgraph_edges.begin(); it!= subgraph_edges.end(); ++it) {
-      if (it->first != it-> second) connected_edge_list.insert(*it);
+    const uint32_t size = (uint32_t) network.get_content(cluster).size();
+    rows_t rows = {cluster, 0, 0, 0};
+    for (uint32_t row = 0; row < size; ++row) {
+      rows.pairs += size - 1 - row;
+      if (threads > 1 && rows.pairs >= pairs_per_task) {
+        rows.last = row + 1;
+        tasks.push_back(rows);
+        rows.first = row + 1;
+        rows.pairs = 0;
+      }
     }
+    rows.last = size;
+    if (rows.first < rows.last) tasks.push_back(rows);
   }
+  if (threads > 1) std::stable_sort(tasks.begin(), tasks.end(), [](const rows_t & a, const rows_t & b) {return a.pairs > b.pairs;});
+  std::vector<edge_list_t> parts(threads);
+  for_each_task(tasks.size(), threads, [&](size_t task, unsigned int worker) {
+    // every pair of distinct nodes of the (sorted) content is linked
+    const incidence_list_t & content = network.get_content(tasks[task].cluster);
+    edge_list_t & part = parts[worker];
+    for (auto it1 = content.begin() + tasks[task].first; it1 != content.begin() + tasks[task].last; ++it1) {
+      for (auto it2 = std::next(it1); it2 != content.end(); ++it2) {
+        if (*it1 != *it2) part.push_back(*it1,*it2);
+      }
+    }
+  });
+  connected_edge_list.merge(parts);
   return;
 }
-void create_projected_internal_degrees(const std::set< edge_t > edge_list, const spa_network_t & network, std::vector<std::vector<unsigned int> > & projected_internal_degrees) {
+void create_projected_internal_degrees(const edge_list_t & edge_list, const spa_network_t & network, std::vector<std::vector<unsigned int> > & projected_internal_degrees, unsigned int threads) {
   projected_internal_degrees.clear();
   projected_internal_degrees.resize(network.size_in_clusters());
-  for (id_t cluster = 0 ; cluster < network.size_in_clusters(); ++cluster) {
+  // the sequences of the communities are independent: each worker fills those of its communities
+  threads = workers(network.size_in_clusters(), threads);
+  const std::vector<id_t> queue = cluster_queue(network, threads, [&network](id_t cluster) {return network.get_content(cluster).size();});
+  for_each_task(queue.size(), threads, [&](size_t task, unsigned int) {
+    const id_t cluster = queue[task];
     LOGGER_WRITE(Logger::DEBUG,VAR_PRINT(cluster))
     // Fetch subgraph info
-    std::multiset<edge_t> duplicate_edges = network.get_subgraph(cluster).get_global_links();
-    std::set<id_t> nodes = network.get_subgraph(cluster).get_global_ids();
+    const subgraph_t & subgraph = network.get_subgraph(cluster);
+    std::set<id_t> nodes = subgraph.get_global_ids();
     std::map<id_t, id_t> global_to_local;
     
 
     // Keep a single copy of each internal edge 
     LOGGER_WRITE(Logger::DEBUG,"Keep a single copy of each internal edge.")
     std::set<edge_t> unique_edges;
-    for (auto it = duplicate_edges.begin(); it!=duplicate_edges.end(); ++it) 
-      unique_edges.insert(*it);
-    duplicate_edges.clear();
+    subgraph.for_each_link([&](id_t internal_node1, id_t internal_node2) {
+      id_t node1 = subgraph.get_global_id(internal_node1);
+      id_t node2 = subgraph.get_global_id(internal_node2);
+      unique_edges.insert(node1 <= node2 ? std::make_pair(node1,node2) : std::make_pair(node2,node1));
+    });
 
     // Project the network onto the subgraph (and build global_to_local map)
     LOGGER_WRITE(Logger::DEBUG,"Project the network onto the subgraph")
@@ -63,26 +142,32 @@ void create_projected_internal_degrees(const std::set< edge_t > edge_list, const
     }
 
     projected_internal_degrees[cluster] = degrees;
-  }
+  });
   return;
 }
-void create_collapsed_internal_degrees(const spa_network_t & network, std::vector<std::vector<unsigned int> > & collapsed_internal_degrees) {
+void create_collapsed_internal_degrees(const spa_network_t & network, std::vector<std::vector<unsigned int> > & collapsed_internal_degrees, unsigned int threads) {
   collapsed_internal_degrees.clear();
   collapsed_internal_degrees.resize(network.size_in_clusters());
-  for (id_t cluster = 0 ; cluster < network.size_in_clusters(); ++cluster) {
+  // the sequences of the communities are independent: each worker fills those of its communities
+  threads = workers(network.size_in_clusters(), threads);
+  const std::vector<id_t> queue = cluster_queue(network, threads, [&network](id_t cluster) {return network.get_content(cluster).size();});
+  for_each_task(queue.size(), threads, [&](size_t task, unsigned int) {
+    const id_t cluster = queue[task];
     LOGGER_WRITE(Logger::DEBUG,VAR_PRINT(cluster))
     // Fetch subgraph info
-    std::multiset<edge_t> duplicate_edges = network.get_subgraph(cluster).get_global_links();
-    std::set<id_t> nodes = network.get_subgraph(cluster).get_global_ids();
+    const subgraph_t & subgraph = network.get_subgraph(cluster);
+    std::set<id_t> nodes = subgraph.get_global_ids();
     std::map<id_t, id_t> global_to_local;
     
 
     // Keep a single copy of each internal edge 
     LOGGER_WRITE(Logger::DEBUG,"Keep a single copy of each internal edge.")
     std::set<edge_t> unique_edges;
-    for (auto it = duplicate_edges.begin(); it!=duplicate_edges.end(); ++it) 
-      unique_edges.insert(*it);
-    duplicate_edges.clear();
+    subgraph.for_each_link([&](id_t internal_node1, id_t internal_node2) {
+      id_t node1 = subgraph.get_global_id(internal_node1);
+      id_t node2 = subgraph.get_global_id(internal_node2);
+      unique_edges.insert(node1 <= node2 ? std::make_pair(node1,node2) : std::make_pair(node2,node1));
+    });
 
 
     // Build global_to_local map
@@ -102,6 +187,85 @@ void create_collapsed_internal_degrees(const spa_network_t & network, std::vecto
     }
 
     collapsed_internal_degrees[cluster] = degrees;
+  });
+  return;
+}
+double ks_distance(std::vector<size_t> sample_1, std::vector<size_t> sample_2) {
+  if (sample_1.empty() || sample_2.empty()) return 0;
+  std::sort(sample_1.begin(), sample_1.end());
+  std::sort(sample_2.begin(), sample_2.end());
+  double distance = 0;
+  size_t i = 0, j = 0;
+  while (i < sample_1.size() && j < sample_2.size()) {
+    // step over every copy of the smallest value, in both samples
+    size_t value = std::min(sample_1[i], sample_2[j]);
+    while (i < sample_1.size() && sample_1[i] == value) ++i;
+    while (j < sample_2.size() && sample_2[j] == value) ++j;
+    distance = std::max(distance, fabs((double) i / sample_1.size() - (double) j / sample_2.size()));
+  }
+  return distance;
+}
+/** Log the Kolmogorov-Smirnov test of two samples. @return true if the test does not reject equality at the 1% level. */
+static bool ks_test(const std::string & name, const std::vector<size_t> & sample, const std::vector<size_t> & reference) {
+  double n = sample.size(), m = reference.size();
+  double distance = ks_distance(sample, reference);
+  double critical_distance = 1.628 * sqrt((n + m) / (n * m)); // alpha = 0.01
+  LOGGER_WRITE(Logger::CONFIG, "Validation, "+name+" distributions: "+VAR_PRINT(distance)+", "+VAR_PRINT(critical_distance)+".")
+  if (distance > critical_distance) {
+    LOGGER_WRITE(Logger::CONFIG, "Validation, "+name+" distributions differ at the 1% level.")
+    return false;
+  }
+  (void) name;
+  return true;
+}
+/** Sizes, memberships and degrees (if links are handled) of a realization. */
+static void create_samples(const spa_network_t & network, std::vector<size_t> & sizes, std::vector<size_t> & memberships, std::vector<size_t> & degrees) {
+  sizes.resize(network.size_in_clusters());
+  for (id_t cluster = 0; cluster < network.size_in_clusters(); ++cluster) sizes[cluster] = network.cluster_size(cluster);
+  memberships.resize(network.size_in_nodes());
+  for (id_t node = 0; node < network.size_in_nodes(); ++node) memberships[node] = network.membership(node);
+  degrees.clear();
+  if (network.link_mode() != LEGACY_LINKS) {
+    edge_list_t edge_list;
+    create_edge_list(network, edge_list);
+    degrees.assign(network.size_in_nodes(), 0);
+    for (auto it = edge_list.begin(); it != edge_list.end(); ++it) {
+      ++degrees[it->first];
+      ++degrees[it->second];
+    }
   }
   return;
-}
\ No newline at end of file
+}
+bool compare_realizations(const spa_network_t & network, const spa_network_t & reference) {
+  std::vector<size_t> sizes, memberships, degrees;
+  std::vector<size_t> reference_sizes, reference_memberships, reference_degrees;
+  create_samples(network, sizes, memberships, degrees);
+  create_samples(reference, reference_sizes, reference_memberships, reference_degrees);
+  bool consistent = ks_test("community size", sizes, reference_sizes);
+  consistent = ks_test("membership", memberships, reference_memberships) && consistent;
+  if (!degrees.empty() && !reference_degrees.empty()) consistent = ks_test("degree", degrees, reference_degrees) && consistent;
+  return consistent;
+}
+network_summary_t summarize_network(const spa_network_t & network, double duration) {
+  network_summary_t summary;
+  const double nodes = network.size_in_nodes();
+  const double clusters = network.size_in_clusters();
+  const double incidences = network.get_incidence_sum();
+  double max_size = 0, max_membership = 0, internal_links = 0;
+  for (id_t cluster = 0; cluster < network.size_in_clusters(); ++cluster) {
+    max_size = std::max(max_size, (double) network.get_content(cluster).size());
+    if (network.link_mode() != LEGACY_LINKS) internal_links += network.get_subgraph(cluster).size_in_links();
+  }
+  for (id_t node = 0; node < network.size_in_nodes(); ++node) {
+    max_membership = std::max(max_membership, (double) network.get_participations(node).size());
+  }
+  summary.values[network_summary_t::NODES] = nodes;
+  summary.values[network_summary_t::CLUSTERS] = clusters;
+  summary.values[network_summary_t::MEAN_SIZE] = clusters > 0 ? incidences / clusters : 0;
+  summary.values[network_summary_t::MAX_SIZE] = max_size;
+  summary.values[network_summary_t::MEAN_MEMBERSHIP] = nodes > 0 ? incidences / nodes : 0;
+  summary.values[network_summary_t::MAX_MEMBERSHIP] = max_membership;
+  summary.values[network_summary_t::INTERNAL_LINKS] = internal_links;
+  summary.values[network_summary_t::DURATION] = duration;
+  return summary;
+}
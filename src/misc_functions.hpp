@@ -1,15 +1,22 @@
 #ifndef MISC_FUNCTIONS_HPP
 #define MISC_FUNCTIONS_HPP
 
+// C libraries
+#include <math.h> // sqrt, fabs (compare_realizations(2))
 // STL
+#include <algorithm> // std::sort (ks_distance(2))
 #include <map>  // global id to local id (create_projected_internal_degrees(3))
-#include <set>  // spa_network_t accessors use sets and multisets
+#include <iterator> // std::next
+#include <set>  // unique edges and global ids of subgraphs
+#include <string> // names of the compared distributions
 #include <vector> // edge list container
 // Project files
 #include "spa_network.hpp" // spa_network_t
 #include "subgraph.hpp" // subgraph_t
+#include "incidence_list.hpp" // incidence_list_t
+#include "edge_list.hpp" // edge_list_t
 // Typdef and helpers
-#include "types.hpp" // id_t, edge_t
+#include "types.hpp" // id_t, edge_t, network_summary_t
 #include "includes/logger.hpp" // LOGGER macros
 
 
@@ -18,18 +25,20 @@
   * are not considered.
   * @remark Return by reference.
   * @param[in] <network> Initialized network object with link handling.
-  * @param[out] <edge_list> The edge list. 
+  * @param[out] <edge_list> The edge list, whose threads collect the links of
+  *                         subsets of the communities before their lists are merged. 
   */
-void create_edge_list(const spa_network_t & network, std::set<edge_t> & edge_list);
+void create_edge_list(const spa_network_t & network, edge_list_t & edge_list);
 /** @name create_edge_list
   * Create an edge list from a network object, assuming complete
   * connectivity for the communities. Duplicate links and self-loops
   * are not considered.
   * @remark Return by reference.
   * @param[in] <network> Initialized network object.
-  * @param[out] <connected_edge_list> The connected edge list. 
+  * @param[out] <connected_edge_list> The connected edge list, whose threads collect the pairs of
+  *                                   blocks of the communities before their lists are merged. 
   */
-void create_connected_edge_list(const spa_network_t & network,  std::set<edge_t> & connected_edge_list);
+void create_connected_edge_list(const spa_network_t & network,  edge_list_t & connected_edge_list);
 /** @name create_projected_internal_degrees
   * Create internal degree sequences from projected network (within subgraphs:
   * duplicate nodes are merged, self-loops are removed, within the network:
@@ -38,14 +47,39 @@ void create_connected_edge_list(const spa_network_t & network,  std::set<edge_t>
   * @param[in] <edge_list> Initialized edge list. 
   * @param[in] <network> Initialized network object.
   * @param[out] <projected_internal_degrees> The internal degree sequences. 
+  * @param[in] <threads> Number of threads, each building the sequences of a subset of the communities (0: one per core).
   */
-void create_projected_internal_degrees(const std::set< edge_t > edge_list, const spa_network_t & network, std::vector<std::vector<unsigned int> > & projected_internal_degrees);
+void create_projected_internal_degrees(const edge_list_t & edge_list, const spa_network_t & network, std::vector<std::vector<unsigned int> > & projected_internal_degrees, unsigned int threads = 1);
 /** @name create_collapsed_internal_degrees
   * Create internal degree sequences from collapsed internal communities (within subgraphs:
   * duplicate nodes are merged, self-loops are removed).
   * @remark Return by reference.
   * @param[in] <network> Initialized network object.
   * @param[out] <collapsed_internal_degrees> The internal degree sequences. 
+  * @param[in] <threads> Number of threads, each building the sequences of a subset of the communities (0: one per core).
   */
-void create_collapsed_internal_degrees(const spa_network_t & network, std::vector<std::vector<unsigned int> > & collapsed_internal_degrees);
+void create_collapsed_internal_degrees(const spa_network_t & network, std::vector<std::vector<unsigned int> > & collapsed_internal_degrees, unsigned int threads = 1);
+/** @name ks_distance
+  * Two-sample Kolmogorov-Smirnov statistic, i.e. the largest distance between
+  * the empirical cumulative distributions of two samples.
+  * @param[in] <sample_1> First sample (copied, then sorted).
+  * @param[in] <sample_2> Second sample (copied, then sorted).
+  */
+double ks_distance(std::vector<size_t> sample_1, std::vector<size_t> sample_2);
+/** @name compare_realizations
+  * Compare the community size, membership and degree (if links are handled)
+  * distributions of two realizations with two-sample Kolmogorov-Smirnov tests,
+  * and log the results (validation of the relaxed growth mode).
+  * @param[in] <network> Tested realization.
+  * @param[in] <reference> Reference realization (sequential growth).
+  * @return true if no test rejects the hypothesis of equal distributions at the 1% level.
+  */
+bool compare_realizations(const spa_network_t & network, const spa_network_t & reference);
+/** @name summarize_network
+  * Scalar statistics of a realization (community sizes and memberships, links
+  * within the subgraphs if links are handled, and simulation duration).
+  * @param[in] <network> Grown network, before its outputs alter it.
+  * @param[in] <duration> Duration of the simulation, in seconds.
+  */
+network_summary_t summarize_network(const spa_network_t & network, double duration);
 #endif //MISC_FUNCTIONS_HPP
\ No newline at end of file
@@ -5,40 +5,59 @@
 // ============================================================================================
 
 // CTOR
-modular_structure_t::modular_structure_t()  : rand_real_(0,1) {
+modular_structure_t::modular_structure_t() {
   incidence_sum_ = 0;
 }
-modular_structure_t::modular_structure_t(size_t size_in_nodes, size_t size_in_clusters)  : rand_real_(0,1) {
+modular_structure_t::modular_structure_t(size_t size_in_nodes, size_t size_in_clusters) {
   incidence_sum_ = 0;
   participations_.reserve(size_in_nodes);
   content_.reserve(size_in_clusters);
+  unique_participations_size_.reserve(size_in_nodes);
+  unique_content_size_.reserve(size_in_clusters);
+  node_sampler_.reserve(size_in_nodes);
+  cluster_sampler_.reserve(size_in_clusters);
 }
 
 
 // ACCESSORS
 // GET ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-size_t modular_structure_t::get_incidence_sum() const {
-  return incidence_sum_;
+template <typename engine_t>
+id_t modular_structure_t::preferential_pick_node(draw_buffer_t<engine_t>& draws) const {
+  return preferential_pick(node_sampler_, draws);
 }
-id_t modular_structure_t::preferential_pick(std::string viewpoint, std::mt19937& engine) {
-  assert(viewpoint.compare("node") == 0 || viewpoint.compare("cluster") == 0);
-  if (viewpoint.compare("cluster") == 0) return preferential_pick(content_, engine);
-  else return preferential_pick(participations_, engine);
+template <typename engine_t>
+id_t modular_structure_t::preferential_pick_cluster(draw_buffer_t<engine_t>& draws) const {
+  return preferential_pick(cluster_sampler_, draws);
 }
 // SET~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void modular_structure_t::set_size_in_nodes(size_t size_in_nodes) {
+  for (id_t node = size_in_nodes; node < participations_.size(); ++node) participations_[node].clear(arena_);
   participations_.resize(size_in_nodes);
+  unique_participations_size_.resize(size_in_nodes,0);
+  rebuild_samplers();
   return;
 }
 void modular_structure_t::set_size_in_clusters(size_t size_in_clusters) {
+  for (id_t cluster = size_in_clusters; cluster < content_.size(); ++cluster) content_[cluster].clear(arena_);
   content_.resize(size_in_clusters);
+  unique_content_size_.resize(size_in_clusters,0);
+  rebuild_samplers();
   return;
 }
 //ABSTACT SET~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void modular_structure_t::add_node_to_cluster(id_t node, id_t cluster) {
   assert(node_exists(node) && cluster_exists(cluster));
-  content_[cluster].insert(node);
-  participations_[node].insert(cluster);
+  // look for the pair in the shortest of the two lists before inserting it.
+  bool new_pair = participations_[node].size() <= content_[cluster].size() ? 
+    participations_[node].count(cluster) == 0 : content_[cluster].count(node) == 0;
+  if (new_pair) {
+    ++unique_participations_size_[node];
+    ++unique_content_size_[cluster];
+  }
+  content_[cluster].insert(node, arena_);
+  participations_[node].insert(cluster, arena_);
+  node_sampler_.increment(node);
+  cluster_sampler_.increment(cluster);
   ++incidence_sum_;
   return;
 }
@@ -47,7 +66,9 @@ void modular_structure_t::add_cluster_to_node(id_t cluster, id_t node) {
 }
 
 id_t modular_structure_t::new_node() {
-  participations_.push_back(std::multiset<id_t>());
+  participations_.push_back(incidence_list_t());
+  unique_participations_size_.push_back(0);
+  node_sampler_.push_back();
   return participations_.size()-1;
 }
 id_t modular_structure_t::new_node(std::multiset<id_t> participations) {
@@ -61,7 +82,9 @@ id_t modular_structure_t::new_node(std::multiset<id_t> participations) {
 }
 
 id_t modular_structure_t::new_cluster() {
-  content_.push_back(std::multiset<id_t>());
+  content_.push_back(incidence_list_t());
+  unique_content_size_.push_back(0);
+  cluster_sampler_.push_back();
   return content_.size()-1;
 }
 id_t modular_structure_t::new_cluster(std::multiset<id_t> content) {
@@ -73,19 +96,34 @@ id_t modular_structure_t::new_cluster(std::multiset<id_t> content) {
   for (auto node = content.begin();node!=content.end();++node) {add_node_to_cluster(*node, new_cluster_id);}
   return new_cluster_id;
 }
+id_t modular_structure_t::new_cluster(const id_t * first, const id_t * last) {
+  #ifndef NDEBUG 
+    // Explicit NDEBUG macro to avoid empty loops at compilation-time.
+    for (const id_t * node = first; node != last; ++node) assert(node_exists(*node) && (node == first || *(node - 1) <= *node));
+  #endif
+  id_t new_cluster_id = new_cluster();
+  for (const id_t * node = first; node != last; ++node) {add_node_to_cluster(*node, new_cluster_id);}
+  return new_cluster_id;
+}
 
 void modular_structure_t::purge_modular_structure(size_t min_community_size) {
   for(id_t cluster = 0 ; cluster<content_.size();++cluster) {
     if (content_[cluster].size()<min_community_size) {
       for (auto it=content_[cluster].begin(); it!=content_[cluster].end(); ++it) {
-        participations_[*it].erase(cluster);
+        // duplicates are erased with the first occurrence of the node (erase returns 0 afterwards).
+        if (participations_[*it].erase(cluster) > 0) --unique_participations_size_[*it];
       }
-      content_[cluster].clear();
+      content_[cluster].clear(arena_);
+      unique_content_size_[cluster] = 0;
     }
   }
+  rebuild_samplers();
   return;
 }
 
+// Memory
+arena_t & modular_structure_t::arena() {return arena_;}
+
 // Boolean tests
 bool modular_structure_t::node_exists(id_t node) const {return node < size_in_nodes();}
 bool modular_structure_t::cluster_exists(id_t cluster) const {return cluster < size_in_clusters();}
@@ -102,41 +140,37 @@ size_t modular_structure_t::size_in_nodes() const {
 size_t modular_structure_t::size_in_clusters() const {
   return content_.size();
 }
+size_t modular_structure_t::get_incidence_sum() const {
+  return incidence_sum_;
+}
 size_t modular_structure_t::membership(id_t node, bool unique) const {
   assert(node_exists(node));
   if (!unique) return participations_[node].size();
-  else         return get_unique_participations(node).size();
+  else         return unique_participations_size_[node];
 }
 size_t modular_structure_t::cluster_size(id_t cluster, bool unique) const {
   assert(cluster_exists(cluster));
   if (!unique)  return content_[cluster].size(); //direct ref to private member removes a copy operation.
-  else          return get_unique_content(cluster).size();
+  else          return unique_content_size_[cluster];
 }
 
 // GET~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-std::multiset<id_t> modular_structure_t::get_participations(id_t node) const {
+const incidence_list_t & modular_structure_t::get_participations(id_t node) const {
   assert(node_exists(node));
   return participations_[node];
 }
-std::multiset<id_t> modular_structure_t::get_content(id_t cluster) const {
+const incidence_list_t & modular_structure_t::get_content(id_t cluster) const {
   assert(cluster_exists(cluster));
   return content_[cluster];
 }
+const arena_t & modular_structure_t::get_arena() const {return arena_;}
 std::set<id_t> modular_structure_t::get_unique_participations(id_t node) const {
   assert(node_exists(node));
-  std::set<id_t> tmp;
-  for (auto it = participations_[node].begin();it!=participations_[node].end();++it) {
-    tmp.insert(*it);
-  }
-  return tmp;
+  return std::set<id_t>(participations_[node].begin(),participations_[node].end());
 }
 std::set<id_t> modular_structure_t::get_unique_content(id_t cluster) const {
   assert(cluster_exists(cluster));
-  std::set<id_t> tmp;
-  for (auto it = content_[cluster].begin();it!=content_[cluster].end();++it) {
-    tmp.insert(*it);
-  }
-  return tmp;
+  return std::set<id_t>(content_[cluster].begin(),content_[cluster].end());
 }
 
 
@@ -145,23 +179,32 @@ std::set<id_t> modular_structure_t::get_unique_content(id_t cluster) const {
 // ============================================================================================
 
 // RNG-related.
-id_t modular_structure_t::preferential_pick(std::vector< std::multiset<id_t> > & vec_of_multiset, std::mt19937& engine) {
-  /* declarations */
-  id_t pick=0;
-  id_t local_count=0;
-  id_t global_count=0;
-  /* choose target "ticket" (# of ticket for node i prop. to. vec_of_multiset[i].size() */
-  id_t target_idx = (id_t) ceil(rand_real_(engine)*(double)incidence_sum_);
-  /* find the node to which the ticket belongs */
-  do {
-    if (local_count == vec_of_multiset[pick].size()) {
-      local_count = 0;
-      ++pick;
-    }
-    else {
-      ++global_count;
-      ++local_count;
-    }
-  } while (global_count!=target_idx);
-  return pick;
-}
\ No newline at end of file
+template <typename engine_t>
+id_t modular_structure_t::preferential_pick(const preferential_sampler_t & sampler, draw_buffer_t<engine_t>& draws) const {
+  assert(sampler.total() == incidence_sum_);
+  /* choose target "ticket" (# of ticket for element i prop. to. its weight in the sampler) */
+  size_t target_idx = (size_t) draws.ticket(incidence_sum_);
+  /* find the element to which the ticket belongs */
+  return sampler.find(target_idx);
+}
+void modular_structure_t::rebuild_samplers() {
+  std::vector<size_t> weights(participations_.size(),0);
+  incidence_sum_ = 0;
+  for (id_t node = 0; node < participations_.size(); ++node) {
+    weights[node] = participations_[node].size();
+    incidence_sum_ += weights[node];
+  }
+  node_sampler_.assign(weights);
+  weights.assign(content_.size(),0);
+  for (id_t cluster = 0; cluster < content_.size(); ++cluster) weights[cluster] = content_[cluster].size();
+  cluster_sampler_.assign(weights);
+  return;
+}
+// ============================================================================================
+// EXPLICIT INSTANTIATIONS ====================================================================
+// ============================================================================================
+
+#define INSTANTIATE_MODULAR_STRUCTURE(ENGINE) \
+  template id_t modular_structure_t::preferential_pick_node<ENGINE>(draw_buffer_t<ENGINE>&) const; \
+  template id_t modular_structure_t::preferential_pick_cluster<ENGINE>(draw_buffer_t<ENGINE>&) const;
+SPA_FOR_EACH_ENGINE(INSTANTIATE_MODULAR_STRUCTURE)
@@ -12,14 +12,18 @@
 // Configuration file
 #include "config.h"
 // C libraries
-#include <math.h>   // ceil
 #include <assert.h> // error checking: turn off with #define NDEBUG
 #include <stddef.h> // size_t
+#include <stdint.h> // uint32_t
 // STL
-#include <set>      // std::multiset (private data members)
-#include <vector>   // std::vector< std::multiset > (private data members)
-#include <random>   // uniform_real_distribution
+#include <set>      // std::multiset and std::set (accessors)
+#include <vector>   // std::vector< incidence_list_t > (private data members)
 #include <iterator> // std::advance
+// Project files
+#include "arena.hpp" // arena_t (private data members)
+#include "incidence_list.hpp" // incidence_list_t (private data members)
+#include "preferential_samplers.hpp" // preferential_sampler_t (private data members)
+#include "draw_buffer.hpp" // draw_buffer_t (explicit instantiations)
 // Typdef and helpers
 #include "types.hpp" // id_t
   
@@ -36,7 +40,9 @@
   *  node in any given cluster, and vice-versa. 
   *
   *  A built-in preferential random GET access methods is also available, to facilitate
-  *  preferential attachment algorithms implementation.
+  *  preferential attachment algorithms implementation. The weights of the picks are 
+  *  kept up to date by a preferential_sampler_t, whose backend is selected at 
+  *  compilation time with the PREFERENTIAL_SAMPLER macro (see config.h).
   *
   */
 class modular_structure_t {
@@ -53,14 +59,18 @@ protected:
   /** @name Protected accessors */
   //@{
   //GET~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  /** Return the sum of the incidence matrix (participations / contents). */
-  size_t get_incidence_sum() const;
-  /** Pick a random node or cluster proportionally to its number of activity. 
-    * @param[in] <viewpoint> "node" or "cluster".
-    * @param[in] <engine> Reference to a std::mt19937 engine.
+  /** Pick a random node proportionally to its number of participations. 
+    * Read-only: concurrent picks are safe as long as the structure is not modified.
+    * @param[in] <draws> Draw buffer of the pseudo-RNG engine (see draw_buffer.hpp).
+    * @see uniform_pick.
+    */
+  template <typename engine_t> id_t preferential_pick_node(draw_buffer_t<engine_t>& draws) const;
+  /** Pick a random cluster proportionally to its size. 
+    * Read-only: concurrent picks are safe as long as the structure is not modified.
+    * @param[in] <draws> Draw buffer of the pseudo-RNG engine (see draw_buffer.hpp).
     * @see uniform_pick.
     */
-  id_t preferential_pick(std::string viewpoint, std::mt19937& engine);
+  template <typename engine_t> id_t preferential_pick_cluster(draw_buffer_t<engine_t>& draws) const;
   //SET~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   /** Act as STL resize(1), i.e. extra nodes do not belong to any clusters if the new size is larger. Destroy information otherwise. */
   void set_size_in_nodes(size_t size_in_nodes);
@@ -89,6 +99,11 @@ protected:
     * @return Id of the new cluster.
     */
   id_t new_cluster(std::multiset<id_t> content);
+  /** Create a new cluster from a sorted range of nodes [first, last[, possibly with duplicates.
+    * Same result as new_cluster(std::multiset<id_t>(first, last)), without the temporary.
+    * @return Id of the new cluster.
+    */
+  id_t new_cluster(const id_t * first, const id_t * last);
   /** Delete all cluster of sizes bellow a certain threshold.
     * @param[in] <min_community_size> Community size threshold.
     * @warning This member function only reduces some elements 
@@ -98,6 +113,12 @@ protected:
   void purge_modular_structure(size_t min_community_size);
   //@}
 
+  /** @name Memory */
+  //@{
+  /** Arena owned by the structure. Containers of derived classes may use it: it is released after their destruction. */
+  arena_t & arena();
+  //@}
+
   /** @name Boolean tests. */
   //@{
   bool node_exists(id_t node) const;
@@ -110,9 +131,11 @@ public:
   size_t size_in_nodes() const;
   /** Return the current number of clusters. */
   size_t size_in_clusters() const;
-  /** Return the current membership numer of a node. */
+  /** Return the sum of the incidence matrix (participations / contents). */
+  size_t get_incidence_sum() const;
+  /** Return the current membership numer of a node. Complexity: O(1). */
   size_t membership(id_t node, bool unique=false) const;
-  /** Return the current size of a cluster. 
+  /** Return the current size of a cluster. Complexity: O(1).
     * @param[in] <cluster> Identifier of the cluster.
     * @param[in] <unique> Count nodes only one time, or multiple times. 
     */
@@ -122,20 +145,24 @@ public:
   /// @name Get accessors 
   //@{
   //GET~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  /** Return the participations of a node */
-  std::multiset<id_t> get_participations(id_t node) const;
-  /** Return the nodes of a cluster */
-  std::multiset<id_t> get_content(id_t cluster) const;
+  /** Return a read-only view of the participations of a node (sorted, with duplicates). No copy is made. */
+  const incidence_list_t & get_participations(id_t node) const;
+  /** Return a read-only view of the nodes of a cluster (sorted, with duplicates). No copy is made. */
+  const incidence_list_t & get_content(id_t cluster) const;
   /** Return the unique participations of a node */
   std::set<id_t> get_unique_participations(id_t node) const;
   /** Return the unique nodes of a cluster */
   std::set<id_t> get_unique_content(id_t cluster) const;
+  /** Return the arena that holds the incidence matrix (and the structures of derived classes), e.g. for memory reports. */
+  const arena_t & get_arena() const;
   //@}
 
 private:
   /** @name RNG-related. */
   //@{
-  id_t preferential_pick(std::vector< std::multiset<id_t> > & vec_of_multiset, std::mt19937& engine);
+  template <typename engine_t> id_t preferential_pick(const preferential_sampler_t & sampler, draw_buffer_t<engine_t>& draws) const;
+  /** Rebuild the samplers from the incidence matrix. Complexity: O(incidence_sum). */
+  void rebuild_samplers();
   //@}
 
   /** @name Private data members */
@@ -143,14 +170,23 @@ private:
   // Trackers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   /// Incidence sum (i.e. participations cardinality or cluster cardinality sum).
   size_t incidence_sum_;
+  //  Memory ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  /// Storage of the incidence lists, declared before them: it is released last, in bulk.
+  arena_t arena_;
   //  State container ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  /*  General remark: We use multisets, and thus a node can appear more than once within a given structure. */
+  /*  General remark: We use sorted multisets (incidence_list_t), and thus a node can appear more than once within a given structure. */
   /// Sparse incidence matrix; communities view point
-  std::vector< std::multiset<id_t> > content_;
+  std::vector< incidence_list_t > content_;
   /// Sparse incidence matrix; node view point  
-  std::vector< std::multiset<id_t> > participations_;
-  /// Internal distribution. Generator must be passed as a service
-  std::uniform_real_distribution<double> rand_real_;
+  std::vector< incidence_list_t > participations_;
+  /// Number of distinct nodes of each cluster (maintained incrementally).
+  std::vector< uint32_t > unique_content_size_;
+  /// Number of distinct clusters of each node (maintained incrementally).
+  std::vector< uint32_t > unique_participations_size_;
+  /// Preferential sampler over the nodes (weights: memberships).
+  preferential_sampler_t node_sampler_;
+  /// Preferential sampler over the clusters (weights: sizes).
+  preferential_sampler_t cluster_sampler_;
   //@}
 };
 
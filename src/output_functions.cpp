@@ -38,60 +38,78 @@ void process_and_output(spa_network_t & network, const spa_parameters_t & param,
   bool app = param.append.value;
 
   // Edge list and degrees
-  std::set< edge_t > edge_list;
-  if (param.edge_list.initialized || param.degrees.initialized || param.connected_degrees.initialized) {
+  edge_list_t edge_list(param.threads.value);
+  if (param.edge_list.initialized || param.degrees.initialized || param.projected_internal_degrees.initialized) {
     LOGGER_WRITE(Logger::INFO, "Build edge list.")
     create_edge_list(network,edge_list);
   }
   if (param.edge_list.initialized) {
     if ( param.edge_list.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output edge list to the stdout.")
-      output_edge_list(edge_list, std::cout);
+      text_writer_t writer(std::cout);
+      output_edge_list(edge_list, writer);
+    }
+    else if (is_compressed_output(param.edge_list.value, param.format.value)) {
+       LOGGER_WRITE(Logger::INFO, "Output edge list to path "+(param.base_path.value + param.edge_list.value)+" compressed.")
+       std::ofstream stream( (param.base_path.value+param.edge_list.value).c_str(), std::ios::out | std::ios::binary);
+       output_compressed_edge_list(edge_list, stream);
+    }
+    else if (is_binary_output(param.edge_list.value, param.format.value)) {
+       LOGGER_WRITE(Logger::INFO, "Output edge list to path "+(param.base_path.value + param.edge_list.value)+" in binary.")
+       std::ofstream stream( (param.base_path.value+param.edge_list.value).c_str(), std::ios::out | std::ios::binary);
+       output_csr_edge_list(network.size_in_nodes(), edge_list, CSR_EDGE_LIST, stream);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output edge list to path "+(param.base_path.value + param.edge_list.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.edge_list.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_edge_list(edge_list,stream);
+       std::ofstream stream( (param.base_path.value+param.edge_list.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_edge_list(edge_list,writer);
     }
   }
   if (param.degrees.initialized) {
     if ( param.degrees.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output degrees to the stdout.")
-      output_degrees(network, edge_list, std::cout);
+      text_writer_t writer(std::cout);
+      output_degrees(network, edge_list, writer);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output degrees to path "+(param.base_path.value + param.degrees.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.degrees.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_degrees(network, edge_list,stream);
+       std::ofstream stream( (param.base_path.value+param.degrees.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_degrees(network, edge_list,writer);
     }
   }
   // Projected internal degrees (require edge list)
   if (param.projected_internal_degrees.initialized) {
     LOGGER_WRITE(Logger::INFO, "Build projected internal degrees.")
     std::vector<std::vector<unsigned int> > projected_internal_degrees;
-    create_projected_internal_degrees(edge_list,network,projected_internal_degrees);
+    create_projected_internal_degrees(edge_list,network,projected_internal_degrees,param.threads.value);
     if ( param.projected_internal_degrees.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output projected internal degrees to the stdout.")
-      output_projected_internal_degrees(projected_internal_degrees, std::cout);
+      text_writer_t writer(std::cout);
+      output_projected_internal_degrees(projected_internal_degrees, writer);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output projected internal degrees to path "+(param.base_path.value + param.projected_internal_degrees.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.projected_internal_degrees.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_projected_internal_degrees(projected_internal_degrees,stream);
+       std::ofstream stream( (param.base_path.value+param.projected_internal_degrees.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_projected_internal_degrees(projected_internal_degrees,writer);
     }
   }
   if (param.collapsed_internal_degrees.initialized) {
     LOGGER_WRITE(Logger::INFO, "Build collapsed internal degrees.")
     std::vector<std::vector<unsigned int> > collapsed_internal_degrees;
-    create_collapsed_internal_degrees(network,collapsed_internal_degrees);
+    create_collapsed_internal_degrees(network,collapsed_internal_degrees,param.threads.value);
     if ( param.collapsed_internal_degrees.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output collapsed internal degrees to the stdout.")
-      output_collapsed_internal_degrees(collapsed_internal_degrees, std::cout);
+      text_writer_t writer(std::cout);
+      output_collapsed_internal_degrees(collapsed_internal_degrees, writer);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output collapsed internal degrees to path "+(param.base_path.value + param.collapsed_internal_degrees.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.collapsed_internal_degrees.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_collapsed_internal_degrees(collapsed_internal_degrees,stream);
+       std::ofstream stream( (param.base_path.value+param.collapsed_internal_degrees.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_collapsed_internal_degrees(collapsed_internal_degrees,writer);
     }
   }
 
@@ -101,18 +119,20 @@ void process_and_output(spa_network_t & network, const spa_parameters_t & param,
   if (param.internal_degrees.initialized) {
     if ( param.internal_degrees.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output internal degrees to the stdout.")
-      output_internal_degrees(network, std::cout);
+      text_writer_t writer(std::cout);
+      output_internal_degrees(network, writer);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output internal degrees to path "+(param.base_path.value + param.internal_degrees.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.internal_degrees.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_internal_degrees(network,stream);
+       std::ofstream stream( (param.base_path.value+param.internal_degrees.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_internal_degrees(network,writer);
     }
   }
 
 
   // Connected edge list and connected degrees
-  std::set< edge_t > connected_edge_list;
+  edge_list_t connected_edge_list(param.threads.value);
   if (param.connected_edge_list.initialized || param.connected_degrees.initialized) {
     LOGGER_WRITE(Logger::INFO, "Build connected edge list.")
     create_connected_edge_list(network,connected_edge_list);
@@ -120,23 +140,37 @@ void process_and_output(spa_network_t & network, const spa_parameters_t & param,
   if (param.connected_edge_list.initialized) {
     if ( param.connected_edge_list.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output connected edge list to the stdout.")
-      output_connected_edge_list(connected_edge_list, std::cout);
+      text_writer_t writer(std::cout);
+      output_connected_edge_list(connected_edge_list, writer);
+    }
+    else if (is_compressed_output(param.connected_edge_list.value, param.format.value)) {
+       LOGGER_WRITE(Logger::INFO, "Output connected edge list to path "+(param.base_path.value + param.connected_edge_list.value)+" compressed.")
+       std::ofstream stream( (param.base_path.value+param.connected_edge_list.value).c_str(), std::ios::out | std::ios::binary);
+       output_compressed_edge_list(connected_edge_list, stream);
+    }
+    else if (is_binary_output(param.connected_edge_list.value, param.format.value)) {
+       LOGGER_WRITE(Logger::INFO, "Output connected edge list to path "+(param.base_path.value + param.connected_edge_list.value)+" in binary.")
+       std::ofstream stream( (param.base_path.value+param.connected_edge_list.value).c_str(), std::ios::out | std::ios::binary);
+       output_csr_edge_list(network.size_in_nodes(), connected_edge_list, CSR_CONNECTED_EDGE_LIST, stream);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output connected edge list to path "+(param.base_path.value + param.connected_edge_list.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.connected_edge_list.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_connected_edge_list(connected_edge_list,stream);
+       std::ofstream stream( (param.base_path.value+param.connected_edge_list.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_connected_edge_list(connected_edge_list,writer);
     }
   }
   if (param.connected_degrees.initialized) {
     if ( param.connected_degrees.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output connected degrees to the stdout.")
-      output_connected_degrees(network, connected_edge_list, std::cout);
+      text_writer_t writer(std::cout);
+      output_connected_degrees(network, connected_edge_list, writer);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output connected connected to path "+(param.base_path.value + param.connected_degrees.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.connected_degrees.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_connected_degrees(network, connected_edge_list,stream);
+       std::ofstream stream( (param.base_path.value+param.connected_degrees.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_connected_degrees(network, connected_edge_list,writer);
     }
   }
   connected_edge_list.clear();
@@ -151,94 +185,92 @@ void process_and_output(spa_network_t & network, const spa_parameters_t & param,
   if (param.cluster_contents.initialized) {
     if ( param.cluster_contents.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output cluster contents to the stdout.")
-      output_cluster_contents(network, std::cout);
+      text_writer_t writer(std::cout);
+      output_cluster_contents(network, writer);
+    }
+    else if (is_binary_output(param.cluster_contents.value, param.format.value)) {
+       LOGGER_WRITE(Logger::INFO, "Output cluster contents to path "+(param.base_path.value + param.cluster_contents.value)+" in binary.")
+       std::ofstream stream( (param.base_path.value+param.cluster_contents.value).c_str(), std::ios::out | std::ios::binary);
+       output_csr_cluster_contents(network, stream);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output cluster contents to path "+(param.base_path.value + param.cluster_contents.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.cluster_contents.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_cluster_contents(network,stream);
+       std::ofstream stream( (param.base_path.value+param.cluster_contents.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_cluster_contents(network,writer);
     }
   }
   if (param.cluster_sizes.initialized) {
     if ( param.cluster_sizes.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output cluster sizes to the stdout.")
-      output_cluster_sizes(network, std::cout);
+      text_writer_t writer(std::cout);
+      output_cluster_sizes(network, writer);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output cluster sizes to path "+(param.base_path.value + param.cluster_sizes.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.cluster_sizes.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_cluster_sizes(network,stream);
+       std::ofstream stream( (param.base_path.value+param.cluster_sizes.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_cluster_sizes(network,writer);
     }
   }
   if (param.node_participations.initialized) {
     if ( param.node_participations.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output node participations to the stdout.")
-      output_node_participations(network, std::cout);
+      text_writer_t writer(std::cout);
+      output_node_participations(network, writer);
+    }
+    else if (is_binary_output(param.node_participations.value, param.format.value)) {
+       LOGGER_WRITE(Logger::INFO, "Output node participations to path "+(param.base_path.value + param.node_participations.value)+" in binary.")
+       std::ofstream stream( (param.base_path.value+param.node_participations.value).c_str(), std::ios::out | std::ios::binary);
+       output_csr_node_participations(network, stream);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output node participations to path "+(param.base_path.value + param.node_participations.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.node_participations.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_node_participations(network,stream);
+       std::ofstream stream( (param.base_path.value+param.node_participations.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_node_participations(network,writer);
     }
   }
   if (param.node_memberships.initialized) {
     if ( param.node_memberships.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output node memberships to the stdout.")
-      output_node_memberships(network, std::cout);
+      text_writer_t writer(std::cout);
+      output_node_memberships(network, writer);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output node memberships to path "+(param.base_path.value + param.node_memberships.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.node_memberships.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_node_memberships(network,stream);
+       std::ofstream stream( (param.base_path.value+param.node_memberships.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_node_memberships(network,writer);
     }
   }
   if (param.timer.initialized) {
     if ( param.timer.value.compare("") == 0 ) {
       LOGGER_WRITE(Logger::INFO, "Output timer to the stdout.")
-      output_timer(duration, std::cout);
+      text_writer_t writer(std::cout);
+      output_timer(duration, writer);
     }
     else {
        LOGGER_WRITE(Logger::INFO, "Output timer to path "+(param.base_path.value + param.timer.value)+" with append="+VAR_EVAL(app)+".")
-       bofstream stream( (param.base_path.value+param.timer.value).c_str(), app ? std::ios::app : std::ios::out);
-       output_timer(duration,stream);
+       std::ofstream stream( (param.base_path.value+param.timer.value).c_str(), app ? std::ios::app : std::ios::out);
+       text_writer_t writer(stream);
+       output_timer(duration,writer);
     }
   }
   return;
 }
-// Generic functions (Helpers) ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-// could be converted to templates
-void output_vector_uint_content(const std::vector<unsigned int> & uint_vec, std::ostream& os, std::string separator) {
-  for (id_t idx = 0; idx < uint_vec.size(); ++idx) 
-    os << uint_vec[idx] << separator;
-  if (separator.compare(" ")==0) os << "\n";
-}
-void output_multiset_id_content(const std::multiset<id_t> & id_multiset, std::ostream& os, std::string separator) {
-  for ( auto it = id_multiset.begin() ; it!=id_multiset.end() ; ++it ) 
-    os << *it << separator;
-  if (separator.compare(" ")==0) os << "\n";
-  return;
-}
-void output_multiset_id_size(const std::multiset<id_t> & id_multiset, std::ostream& os) {
-  os << id_multiset.size() <<"\n";
-  return;
-}
-void output_set_id_size(const std::set<id_t> & id_multiset, std::ostream& os) {
-  os << id_multiset.size() <<"\n";
-  return;
-}
-
 // Processed data output ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-void output_edge_list(const std::set< edge_t > & edge_list, std::ostream& os) {
+void output_edge_list(const edge_list_t & edge_list, text_writer_t& os) {
   for (auto it = edge_list.begin(); it!=edge_list.end(); ++it)
     os << it->first << " " << it->second << "\n";
   return;
 }
-void output_connected_edge_list(const std::set< edge_t > & connected_edge_list, std::ostream& os) {
+void output_connected_edge_list(const edge_list_t & connected_edge_list, text_writer_t& os) {
   for (auto it = connected_edge_list.begin(); it!=connected_edge_list.end(); ++it)
     os << it->first << " " << it->second << "\n";
   return;
 }
-void output_degrees(const spa_network_t & network, const std::set< edge_t > & edge_list, std::ostream& os) {
+void output_degrees(const spa_network_t & network, const edge_list_t & edge_list, text_writer_t& os) {
   // build degrees
   std::vector<unsigned int> degrees(network.size_in_nodes(),0);
   for (auto it = edge_list.begin(); it!=edge_list.end();++it) {
@@ -246,10 +278,10 @@ void output_degrees(const spa_network_t & network, const std::set< edge_t > & ed
     degrees[it->second]+=1;
   }
   // output
-  output_vector_uint_content(degrees,os,"\n");
+  output_content(degrees,os,"\n");
   return;
 }
-void output_connected_degrees(const spa_network_t & network, const std::set< edge_t > & connected_edge_list, std::ostream& os) {
+void output_connected_degrees(const spa_network_t & network, const edge_list_t & connected_edge_list, text_writer_t& os) {
   // build degrees
   std::vector<unsigned int> connected_degrees(network.size_in_nodes(),0);
   for (auto it = connected_edge_list.begin(); it!=connected_edge_list.end();++it) {
@@ -257,44 +289,94 @@ void output_connected_degrees(const spa_network_t & network, const std::set< edg
     connected_degrees[it->second]+=1;
   }
   // output
-  output_vector_uint_content(connected_degrees,os,"\n");
+  output_content(connected_degrees,os,"\n");
   return;
 }
-void output_timer(const double duration, std::ostream& os) {os << duration << "\n";}
-void output_projected_internal_degrees(const std::vector<std::vector<unsigned int> > & projected_internal_degrees, std::ostream& os) {
+void output_timer(const double duration, text_writer_t& os) {os << duration << "\n";}
+void output_projected_internal_degrees(const std::vector<std::vector<unsigned int> > & projected_internal_degrees, text_writer_t& os) {
   for (id_t cluster = 0; cluster < projected_internal_degrees.size(); ++cluster)
-    output_vector_uint_content(projected_internal_degrees[cluster],os," ");
+    output_content(projected_internal_degrees[cluster],os," ");
   return;
 }
-void output_collapsed_internal_degrees(const std::vector<std::vector<unsigned int> > & collapsed_internal_degrees, std::ostream& os) {
+void output_collapsed_internal_degrees(const std::vector<std::vector<unsigned int> > & collapsed_internal_degrees, text_writer_t& os) {
   for (id_t cluster = 0; cluster < collapsed_internal_degrees.size(); ++cluster)
-    output_vector_uint_content(collapsed_internal_degrees[cluster],os," ");
+    output_content(collapsed_internal_degrees[cluster],os," ");
   return;
 }
 
 // Straightforward outputs ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-void output_cluster_contents(const spa_network_t & network, std::ostream& os) {
+void output_cluster_contents(const spa_network_t & network, text_writer_t& os) {
   for (id_t cluster = 0; cluster < network.size_in_clusters(); ++cluster) 
-    output_multiset_id_content(network.get_content(cluster),os," ");
+    output_content(network.get_content(cluster),os," ");
   return;
 }
-void output_cluster_sizes(const spa_network_t & network, std::ostream& os) {
+void output_cluster_sizes(const spa_network_t & network, text_writer_t& os) {
   for (id_t cluster = 0; cluster < network.size_in_clusters(); ++cluster) 
-    output_multiset_id_size(network.get_content(cluster),os);
+    output_size(network.get_content(cluster),os);
   return;
 }
-void output_node_participations(const spa_network_t & network, std::ostream& os) {
+void output_node_participations(const spa_network_t & network, text_writer_t& os) {
   for (id_t node = 0; node < network.size_in_nodes(); ++node) 
-    output_multiset_id_content(network.get_participations(node),os," ");
+    output_content(network.get_participations(node),os," ");
   return;
 }
-void output_node_memberships(const spa_network_t & network, std::ostream& os)  {
+void output_node_memberships(const spa_network_t & network, text_writer_t& os)  {
   for (id_t node = 0; node < network.size_in_nodes(); ++node) 
-    output_multiset_id_size(network.get_participations(node),os);
+    output_size(network.get_participations(node),os);
+  return;
+}
+void output_internal_degrees(const spa_network_t & network, text_writer_t& os) {
+  for (id_t cluster = 0; cluster < network.size_in_clusters(); ++cluster) {
+    const subgraph_t & subgraph = network.get_subgraph(cluster);
+    for (id_t node = 0; node < subgraph.size_in_nodes(); ++node)
+      os << subgraph.internal_degree(node) << " ";
+    os << "\n";
+  }
+  return;
+}
+
+// Statistics of ensembles and sweeps ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void output_realization_statistics(const std::string & group, const std::string & label, unsigned int seed, unsigned int realization, const network_summary_t & summary, std::ostream& os) {
+  // the label of a lone realization is empty (no prefix)
+  os << group << " " << (label.empty() ? "-" : label) << " " << seed << " " << realization;
+  for (unsigned int field = 0; field < network_summary_t::FIELDS; ++field) os << " " << summary.values[field];
+  os << "\n";
   return;
 }
-void output_internal_degrees(const spa_network_t & network, std::ostream& os) {
-  for (id_t cluster = 0; cluster < network.size_in_clusters(); ++cluster)
-    output_vector_uint_content(network.get_subgraph(cluster).get_internal_degrees(),os," ");
+void output_aggregate_statistics(std::istream& realizations, std::ostream& os) {
+  // statistics of each label, then realizations of each group
+  std::map< std::string, std::pair<std::string, network_summary_t> > labels;
+  std::string line, group, label;
+  unsigned int seed, realization;
+  while (getline(realizations, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    network_summary_t summary;
+    fields >> group >> label >> seed >> realization;
+    for (unsigned int field = 0; field < network_summary_t::FIELDS; ++field) fields >> summary.values[field];
+    if (fields) labels[label] = std::make_pair(group, summary);
+  }
+  std::map< std::string, std::vector<network_summary_t> > groups;
+  for (auto it = labels.begin(); it != labels.end(); ++it) groups[it->second.first].push_back(it->second.second);
+
+  os << "# group realizations";
+  for (unsigned int field = 0; field < network_summary_t::FIELDS; ++field) os << " " << network_summary_t::name(field) << " " << network_summary_t::name(field) << "_std";
+  os << "\n";
+  for (auto it = groups.begin(); it != groups.end(); ++it) {
+    const std::vector<network_summary_t> & summaries = it->second;
+    os << it->first << " " << summaries.size();
+    for (unsigned int field = 0; field < network_summary_t::FIELDS; ++field) {
+      double sum = 0, sum_of_squares = 0;
+      for (auto summary = summaries.begin(); summary != summaries.end(); ++summary) {
+        sum += summary->values[field];
+        sum_of_squares += summary->values[field] * summary->values[field];
+      }
+      const double mean = sum / summaries.size();
+      // sample standard deviation (0 for a single realization)
+      const double variance = summaries.size() > 1 ? (sum_of_squares - sum * mean) / (summaries.size() - 1) : 0;
+      os << " " << mean << " " << sqrt(variance > 0 ? variance : 0);
+    }
+    os << "\n";
+  }
   return;
-}
\ No newline at end of file
+}
@@ -5,45 +5,73 @@
 #include "config.h"
 // STL
 #include <iostream> // ostream
-#include <set>  // spa_network_t accessors use sets and multisets
+#include <fstream> // output files
 #include <vector> // edge list container
 #include <string> // separators in generic output functions
+#include <map>  // realizations of the groups (aggregate statistics)
+#include <sstream> // statistics lines
+#include <math.h> // sqrt (aggregate statistics)
 // Project files
 #include "spa_network.hpp" // spa_network_t
 #include "subgraph.hpp" // subgraph_t
 #include "misc_functions.hpp" //edge_list builders
+#include "edge_list.hpp" // edge_list_t
+#include "binary_output.hpp" // binary (CSR) outputs
+#include "compressed_edge_list.hpp" // compressed edge lists
+#include "text_writer.hpp" // text_writer_t
 // Typdef and helpers
-#include "types.hpp" // spa_parameters_t, id_t, edge_t
+#include "types.hpp" // spa_parameters_t, id_t, edge_t, network_summary_t
 #include "includes/logger.hpp"  // LOGGER macros
-#include "includes/bofstream.hpp" // buffered output stream
 
 /// Unified interface with main()
 void process_and_output(spa_network_t & network, const spa_parameters_t & param, const double duration);
-/// Generic functions
+/// Generic functions (any container with begin(), end() and size(), e.g. std::vector or incidence_list_t)
 //@{
-void output_vector_uint_content(const std::vector<unsigned int> & uint_vec, std::ostream& os, std::string separator);
-void output_multiset_id_content(const std::multiset<id_t> & id_multiset, std::ostream& os, std::string separator);
-void output_multiset_id_size(const std::multiset<id_t> & id_multiset, std::ostream& os);
-void output_set_id_size(const std::set<id_t> & id_multiset, std::ostream& os);
+template <typename container_t> void output_content(const container_t & container, text_writer_t& os, const std::string & separator);
+template <typename container_t> void output_size(const container_t & container, text_writer_t& os);
 //@}
 
 /// Processed data output
 //@{
-void output_edge_list(const std::set< edge_t > & edge_list, std::ostream& os);
-void output_connected_edge_list(const std::set< edge_t > & connected_edge_list, std::ostream& os);
-void output_degrees(const spa_network_t & network, const std::set< edge_t > & edge_list, std::ostream& os);
-void output_connected_degrees(const spa_network_t & network, const std::set< edge_t > & connected_edge_list, std::ostream& os);
-void output_timer(const double duration, std::ostream& os);
-void output_projected_internal_degrees(const std::vector<std::vector<unsigned int> > & projected_internal_degrees, std::ostream& os);
-void output_collapsed_internal_degrees(const std::vector<std::vector<unsigned int> > & collapsed_internal_degrees, std::ostream& os);
+void output_edge_list(const edge_list_t & edge_list, text_writer_t& os);
+void output_connected_edge_list(const edge_list_t & connected_edge_list, text_writer_t& os);
+void output_degrees(const spa_network_t & network, const edge_list_t & edge_list, text_writer_t& os);
+void output_connected_degrees(const spa_network_t & network, const edge_list_t & connected_edge_list, text_writer_t& os);
+void output_timer(const double duration, text_writer_t& os);
+void output_projected_internal_degrees(const std::vector<std::vector<unsigned int> > & projected_internal_degrees, text_writer_t& os);
+void output_collapsed_internal_degrees(const std::vector<std::vector<unsigned int> > & collapsed_internal_degrees, text_writer_t& os);
 //@}
 
 /// Straightforward outputs
 //@{
-void output_cluster_contents(const spa_network_t & network, std::ostream& os);
-void output_cluster_sizes(const spa_network_t & network, std::ostream& os);
-void output_node_participations(const spa_network_t & network, std::ostream& os);
-void output_node_memberships(const spa_network_t & network, std::ostream& os);
-void output_internal_degrees(const spa_network_t & network, std::ostream& os);
+void output_cluster_contents(const spa_network_t & network, text_writer_t& os);
+void output_cluster_sizes(const spa_network_t & network, text_writer_t& os);
+void output_node_participations(const spa_network_t & network, text_writer_t& os);
+void output_node_memberships(const spa_network_t & network, text_writer_t& os);
+void output_internal_degrees(const spa_network_t & network, text_writer_t& os);
 //@}
+
+/// Statistics of ensembles and sweeps
+//@{
+/** One line per realization: group, label, seed and index of the realization, then its statistics. */
+void output_realization_statistics(const std::string & group, const std::string & label, unsigned int seed, unsigned int realization, const network_summary_t & summary, std::ostream& os);
+/** Reduce the lines written by output_realization_statistics(5) to the mean and the standard deviation of
+  * each statistic over the realizations of each group (the last line of a label counts).
+  */
+void output_aggregate_statistics(std::istream& realizations, std::ostream& os);
+//@}
+
+// Generic functions (Helpers) ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+template <typename container_t> 
+void output_content(const container_t & container, text_writer_t& os, const std::string & separator) {
+  for (auto it = container.begin(); it!=container.end(); ++it) 
+    os << *it << separator;
+  if (separator.compare(" ")==0) os << "\n";
+  return;
+}
+template <typename container_t> 
+void output_size(const container_t & container, text_writer_t& os) {
+  os << container.size() <<"\n";
+  return;
+}
 #endif // OUTPUT_FUNCTIONS_HPP
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "preferential_samplers.hpp"
+
+// ============================================================================================
+// LINEAR =====================================================================================
+// ============================================================================================
+
+linear_sampler_t::linear_sampler_t() : total_(0) { }
+void linear_sampler_t::reserve(size_t n) {weights_.reserve(n);}
+void linear_sampler_t::clear() {
+  weights_.clear();
+  total_ = 0;
+}
+size_t linear_sampler_t::size() const {return weights_.size();}
+size_t linear_sampler_t::total() const {return total_;}
+void linear_sampler_t::push_back() {weights_.push_back(0);}
+void linear_sampler_t::increment(id_t idx) {
+  assert(idx < size());
+  ++weights_[idx];
+  ++total_;
+}
+void linear_sampler_t::assign(const std::vector<size_t> & weights) {
+  weights_ = weights;
+  total_ = 0;
+  for (auto it = weights_.begin(); it != weights_.end(); ++it) total_ += *it;
+}
+id_t linear_sampler_t::find(size_t ticket) const {
+  assert(ticket > 0 && ticket <= total_);
+  id_t pick = 0;
+  size_t global_count = weights_[0];
+  while (global_count < ticket) global_count += weights_[++pick];
+  return pick;
+}
+
+// ============================================================================================
+// FENWICK ====================================================================================
+// ============================================================================================
+
+fenwick_sampler_t::fenwick_sampler_t() : tree_(1,0), total_(0), top_bit_(0) { }
+void fenwick_sampler_t::reserve(size_t n) {tree_.reserve(n+1);}
+void fenwick_sampler_t::clear() {
+  tree_.assign(1,0);
+  total_ = 0;
+  top_bit_ = 0;
+}
+size_t fenwick_sampler_t::size() const {return tree_.size()-1;}
+size_t fenwick_sampler_t::total() const {return total_;}
+void fenwick_sampler_t::push_back() {
+  // The new node covers ]i - lowbit(i), i], whose only non-empty part is ]i - lowbit(i), i-1].
+  size_t i = tree_.size();
+  size_t lower = i - (i & (~i + 1));
+  size_t partial_sum = 0;
+  for (size_t j = i - 1; j > lower; j -= j & (~j + 1)) partial_sum += tree_[j];
+  tree_.push_back(partial_sum);
+  if (top_bit_ == 0) top_bit_ = 1;
+  else if (top_bit_ << 1 <= size()) top_bit_ <<= 1;
+}
+void fenwick_sampler_t::increment(id_t idx) {
+  assert(idx < size());
+  for (size_t i = (size_t) idx + 1; i < tree_.size(); i += i & (~i + 1)) ++tree_[i];
+  ++total_;
+}
+void fenwick_sampler_t::assign(const std::vector<size_t> & weights) {
+  clear();
+  tree_.resize(weights.size()+1,0);
+  for (size_t i = 1; i < tree_.size(); ++i) {
+    tree_[i] += weights[i-1];
+    total_ += weights[i-1];
+    size_t parent = i + (i & (~i + 1));
+    if (parent < tree_.size()) tree_[parent] += tree_[i];
+  }
+  top_bit_ = size() > 0 ? 1 : 0;
+  while (top_bit_ > 0 && top_bit_ << 1 <= size()) top_bit_ <<= 1;
+}
+id_t fenwick_sampler_t::find(size_t ticket) const {
+  assert(ticket > 0 && ticket <= total_);
+  // Descend the implicit tree: pos is the largest prefix whose sum is smaller than ticket.
+  size_t pos = 0;
+  for (size_t step = top_bit_; step > 0; step >>= 1) {
+    if (pos + step < tree_.size() && tree_[pos + step] < ticket) {
+      pos += step;
+      ticket -= tree_[pos];
+    }
+  }
+  return (id_t) pos; // 0-based identifier of the element that follows the prefix
+}
+
+// ============================================================================================
+// URN ========================================================================================
+// ============================================================================================
+
+urn_sampler_t::urn_sampler_t() : size_(0) { }
+void urn_sampler_t::reserve(size_t n) {urn_.reserve(n);}
+void urn_sampler_t::clear() {
+  urn_.clear();
+  size_ = 0;
+}
+size_t urn_sampler_t::size() const {return size_;}
+size_t urn_sampler_t::total() const {return urn_.size();}
+void urn_sampler_t::push_back() {++size_;}
+void urn_sampler_t::increment(id_t idx) {
+  assert(idx < size());
+  urn_.push_back(idx);
+}
+void urn_sampler_t::assign(const std::vector<size_t> & weights) {
+  clear();
+  size_ = weights.size();
+  for (id_t idx = 0; idx < weights.size(); ++idx) urn_.insert(urn_.end(), weights[idx], idx);
+}
+id_t urn_sampler_t::find(size_t ticket) const {
+  assert(ticket > 0 && ticket <= total());
+  return urn_[ticket-1];
+}
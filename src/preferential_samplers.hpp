@@ -0,0 +1,116 @@
+#ifndef PREFERENTIAL_SAMPLERS_HPP
+#define PREFERENTIAL_SAMPLERS_HPP
+/**
+  * @file preferential_samplers.hpp
+  * @brief Weighted samplers backing the preferential picks of modular_structure_t.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <assert.h> // error checking: turn off with #define NDEBUG
+#include <stddef.h> // size_t
+// STL
+#include <vector>   // weights, trees and urns
+// Typdef and helpers
+#include "types.hpp" // id_t
+
+/*  All samplers share the same minimal interface:
+ *
+ *    push_back()         append an element of weight 0,
+ *    increment(idx)      add one ticket to element idx,
+ *    assign(weights)     rebuild the sampler from scratch,
+ *    find(ticket)        return the owner of the ticket-th ticket (1-based),
+ *
+ *  where tickets are ordered element by element, i.e. the tickets of element 0
+ *  come first, then those of element 1, etc. The random draw of the ticket is
+ *  left to the caller, so that every backend consumes the pseudo-RNG in the same way.
+ */
+
+/** @class linear_sampler_t
+  * @brief Legacy sampler: linear scan over the weights.
+  * @remark Complexity: O(1) update, O(n) pick.
+  */
+class linear_sampler_t {
+public:
+  linear_sampler_t();
+  void reserve(size_t n);
+  void clear();
+  size_t size() const;
+  size_t total() const;
+  void push_back();
+  void increment(id_t idx);
+  void assign(const std::vector<size_t> & weights);
+  id_t find(size_t ticket) const;
+private:
+  /// Number of tickets of each element.
+  std::vector<size_t> weights_;
+  /// Sum of the weights.
+  size_t total_;
+};
+
+/** @class fenwick_sampler_t
+  * @brief Binary indexed tree over the weights.
+  *
+  * Returns exactly the same element as the linear scan for a given ticket,
+  * such that results are reproducible across the two backends.
+  * @remark Complexity: O(log n) update, O(log n) pick, amortized O(log n) push_back.
+  */
+class fenwick_sampler_t {
+public:
+  fenwick_sampler_t();
+  void reserve(size_t n);
+  void clear();
+  size_t size() const;
+  size_t total() const;
+  void push_back();
+  void increment(id_t idx);
+  void assign(const std::vector<size_t> & weights);
+  id_t find(size_t ticket) const;
+private:
+  /// Partial sums (1-based): tree_[i] holds the weights of the elements ]i - lowbit(i), i].
+  std::vector<size_t> tree_;
+  /// Sum of the weights.
+  size_t total_;
+  /// Largest power of two that is smaller or equal to the number of elements.
+  size_t top_bit_;
+};
+
+/** @class urn_sampler_t
+  * @brief Ticket urn: one entry per ticket.
+  *
+  * Tickets are stored in insertion order rather than element by element: the
+  * distribution of the picks is the same as the other backends, but the
+  * sequence of picks for a given seed is not.
+  * @remark Complexity: O(1) update, O(1) pick, one id_t per ticket in memory.
+  */
+class urn_sampler_t {
+public:
+  urn_sampler_t();
+  void reserve(size_t n);
+  void clear();
+  size_t size() const;
+  size_t total() const;
+  void push_back();
+  void increment(id_t idx);
+  void assign(const std::vector<size_t> & weights);
+  id_t find(size_t ticket) const;
+private:
+  /// Owner of each ticket.
+  std::vector<id_t> urn_;
+  /// Number of elements.
+  size_t size_;
+};
+
+#if PREFERENTIAL_SAMPLER == 0
+  typedef linear_sampler_t preferential_sampler_t;
+#elif PREFERENTIAL_SAMPLER == 2
+  typedef urn_sampler_t preferential_sampler_t;
+#else
+  typedef fenwick_sampler_t preferential_sampler_t;
+#endif
+
+#endif //PREFERENTIAL_SAMPLERS_HPP
@@ -0,0 +1,205 @@
+#ifndef RNG_ENGINES_HPP
+#define RNG_ENGINES_HPP
+/**
+  * @file rng_engines.hpp
+  * @brief Pseudo random number engines usable by the SPA drivers.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <stdint.h> // uint32_t, uint64_t
+// STL
+#include <random>   // std::mt19937
+#include <string>   // engine names
+#include <limits>   // std::numeric_limits
+
+/*  Every sampling method of modular_structure_t, spa_network_t and the SPA 
+ *  drivers is a template over the engine type. The templates are defined in 
+ *  the translation units and explicitly instantiated for each engine listed in 
+ *  SPA_FOR_EACH_ENGINE: adding an engine amounts to defining a class that 
+ *  satisfies the UniformRandomBitGenerator requirements, and listing it here.
+ *
+ *  std::mt19937 is the reference engine: it produces the same networks as 
+ *  every previous version for a given seed.
+ */
+
+/// 128 bits unsigned integer (GCC and Clang extension, __extension__ silences -pedantic).
+__extension__ typedef unsigned __int128 uint128_t;
+
+/** @class xoshiro256pp_t
+  * @brief xoshiro256++ 1.0 (Blackman and Vigna), 256 bits of state, 64 bits outputs.
+  */
+class xoshiro256pp_t {
+public:
+  typedef uint64_t result_type;
+  static constexpr result_type min() {return 0;}
+  static constexpr result_type max() {return std::numeric_limits<result_type>::max();}
+
+  /// The state is expanded from the seed with splitmix64, as recommended by the authors.
+  explicit xoshiro256pp_t(uint64_t seed) {
+    for (int i = 0; i < 4; ++i) {
+      seed += 0x9e3779b97f4a7c15ULL;
+      uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      s_[i] = z ^ (z >> 31);
+    }
+  }
+  result_type operator()() {
+    const uint64_t result = rotl(s_[0] + s_[3], 23) + s_[0];
+    const uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+private:
+  static uint64_t rotl(uint64_t x, int k) {return (x << k) | (x >> (64 - k));}
+  uint64_t s_[4];
+};
+
+/** @class pcg64_t
+  * @brief PCG64 (O'Neill), i.e. PCG XSL RR 128/64: 128 bits LCG with a permuted 64 bits output.
+  * @warning Relies on the 128 bits integer extension (uint128_t: GCC, Clang).
+  */
+class pcg64_t {
+public:
+  typedef uint64_t result_type;
+  static constexpr result_type min() {return 0;}
+  static constexpr result_type max() {return std::numeric_limits<result_type>::max();}
+
+  /// Seeding procedure of pcg_setseq_128 (reference implementation).
+  explicit pcg64_t(uint64_t seed, uint64_t stream = 0xda3e39cb94b95bdbULL) : state_(0) {
+    increment_ = ((uint128_t) stream << 1) | 1;
+    step();
+    state_ += seed;
+    step();
+  }
+  result_type operator()() {
+    step();
+    uint64_t xored = (uint64_t) (state_ >> 64) ^ (uint64_t) state_;
+    unsigned int rotation = (unsigned int) (state_ >> 122);
+    return (xored >> rotation) | (xored << ((64 - rotation) & 63));
+  }
+
+private:
+  void step() {
+    const uint128_t multiplier = ((uint128_t) 2549297995355413924ULL << 64) | 4865540595714422341ULL;
+    state_ = state_ * multiplier + increment_;
+  }
+  uint128_t state_;
+  uint128_t increment_;
+};
+
+/// Phases of a realization that draw from distinct streams (see philox4x32_t).
+enum rng_phase_t {
+  SIMULATION_PHASE = 0,
+  CLUSTER_PHASE = 1,
+  OUTPUT_PHASE = 2,
+  /// Relaxed-consistency growth (decisions and picks, see spa_relaxed).
+  RELAXED_PHASE = 3
+};
+
+/** @class philox4x32_t
+  * @brief Philox4x32-10 (Salmon et al., SC'11): counter-based engine, 64 bits outputs.
+  *
+  * Output block i of a stream is a bijection of the 128-bit counter (i, phase, index),
+  * keyed by (seed, realization). Streams are thus identified by a key rather than by
+  * a position in a sequence: any stream can be regenerated on its own, in any order 
+  * and on any thread, and jumping ahead (discard) is O(1). 
+  * Each stream holds 2^65 outputs.
+  */
+class philox4x32_t {
+public:
+  typedef uint64_t result_type;
+  static constexpr result_type min() {return 0;}
+  static constexpr result_type max() {return std::numeric_limits<result_type>::max();}
+
+  /** Stream (@p seed, @p realization, @p phase, @p index).
+    * @param[in] <seed> Seed of the realizations.
+    * @param[in] <realization> Index of the realization (ensembles).
+    * @param[in] <phase> Phase of the realization (see rng_phase_t).
+    * @param[in] <index> Sub-stream of the phase, e.g. a cluster identifier.
+    */
+  explicit philox4x32_t(uint32_t seed, uint32_t realization = 0, uint32_t phase = SIMULATION_PHASE, uint32_t index = 0) 
+    : block_(0), next_(2) {
+    key_[0] = seed;
+    key_[1] = realization;
+    counter_[2] = phase;
+    counter_[3] = index;
+  }
+  /** Independent stream of the same realization. */
+  philox4x32_t split(uint32_t phase, uint32_t index) const {return philox4x32_t(key_[0], key_[1], phase, index);}
+  result_type operator()() {
+    if (next_ == 2) generate();
+    return output_[next_++];
+  }
+  /** Skip @p n outputs. Complexity: O(1). */
+  void discard(unsigned long long n) {
+    // position of the next output in the stream (2 outputs per block)
+    const uint64_t position = 2 * block_ - 2 + next_ + n;
+    block_ = position / 2;
+    next_ = 2;
+    if (position % 2 != 0) {
+      generate();
+      next_ = 1;
+    }
+  }
+
+private:
+  void generate() {
+    uint32_t ctr[4] = {(uint32_t) block_, (uint32_t) (block_ >> 32), counter_[2], counter_[3]};
+    uint32_t key[2] = {key_[0], key_[1]};
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        key[0] += 0x9E3779B9U;
+        key[1] += 0xBB67AE85U;
+      }
+      const uint64_t product0 = (uint64_t) 0xD2511F53U * ctr[0];
+      const uint64_t product1 = (uint64_t) 0xCD9E8D57U * ctr[2];
+      const uint32_t next[4] = {(uint32_t) (product1 >> 32) ^ ctr[1] ^ key[0], (uint32_t) product1,
+                                (uint32_t) (product0 >> 32) ^ ctr[3] ^ key[1], (uint32_t) product0};
+      for (int i = 0; i < 4; ++i) ctr[i] = next[i];
+    }
+    output_[0] = ((uint64_t) ctr[1] << 32) | ctr[0];
+    output_[1] = ((uint64_t) ctr[3] << 32) | ctr[2];
+    ++block_;
+    next_ = 0;
+  }
+  /// Key: seed and realization.
+  uint32_t key_[2];
+  /// Counter: block_ (words 0 and 1), phase (word 2) and index (word 3).
+  uint32_t counter_[4];
+  uint64_t block_;
+  /// Outputs of the last block, output_[next_] is the next one.
+  uint64_t output_[2];
+  unsigned int next_;
+};
+
+/** 64 bits seed of the realization @p realization of an ensemble seeded with @p seed (xoshiro256pp_t, pcg64_t).
+  * Distinct pairs give distinct seeds, and realization 0 is seeded with @p seed alone.
+  */
+inline uint64_t realization_key(uint32_t seed, uint32_t realization) {return ((uint64_t) realization << 32) | seed;}
+
+/// Apply MACRO to every engine supported by the SPA drivers (explicit instantiations).
+#define SPA_FOR_EACH_ENGINE(MACRO) \
+  MACRO(std::mt19937) \
+  MACRO(xoshiro256pp_t) \
+  MACRO(pcg64_t) \
+  MACRO(philox4x32_t)
+
+/// Names of the engines, as accepted on the command line.
+inline bool is_valid_engine_name(const std::string & name) {
+  return name.compare("mt19937") == 0 || name.compare("xoshiro256pp") == 0 || name.compare("pcg64") == 0 ||
+         name.compare("philox") == 0;
+}
+
+#endif //RNG_ENGINES_HPP
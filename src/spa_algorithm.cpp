@@ -1,9 +1,102 @@
 #include "spa_algorithm.hpp"
 
-void spa_star (double p, double q, double r, spa_network_t & network, std::mt19937& engine) {
+// STL
+#include <utility> // std::forward
+#include <algorithm> // std::min, std::max
+#include <atomic>  // std::atomic (relaxed growth)
+#include <thread>  // std::thread (relaxed growth)
+
+/// Relaxed growth: longest epoch, in structural events.
+static const size_t relaxed_max_epoch = 65536;
+/// Relaxed growth: number of events whose picks are drawn from the same stream.
+static const size_t relaxed_chunk_size = 256;
+/// Relaxed growth: shortest epoch whose picks are drawn in parallel (shorter ones do not pay for the threads).
+static const size_t relaxed_parallel_epoch = 4096;
+
+/** Apply the blocks of the scheduler until the network reaches its target size. 
+  * @param[in] <link_rate> Link creation steps per structural event (0: no links, i.e. spa_basic).
+  */
+template <link_mode_t links, unsigned int s, typename engine_t>
+static void spa_scheduled(double p, double q, double link_rate, spa_network_t & network, draw_buffer_t<engine_t> & draws, const batch_observer_t & on_batch) {
+  spa_scheduler_t<engine_t> scheduler(p, q, link_rate, draws);
+  #if LOGGER_LEVEL < 3
+    unsigned int quiet_size = 0;
+  #endif
+  while (network.size_in_nodes()<network.target_size()) {
+    const std::vector<spa_event_t> & block = scheduler.next_block();
+    for (auto event = block.begin(); event != block.end() && network.size_in_nodes()<network.target_size(); ++event) {
+      for (uint64_t i = 0; i < event->links_before; ++i) network.link_kernel<links>(draws);
+      if (event->birth) network.birth_kernel<links, s>(event->new_individual, draws);
+      else network.growth_kernel<links>(event->new_individual, draws);
+      if (event->link_after) network.link_kernel<links>(draws);
+    }
+    LOGGER_WRITE(Logger::DEBUG, "End of batch, current size:"+VAR_PRINT(network.size_in_nodes()))
+    #if LOGGER_LEVEL < 3 
+      if (network.size_in_nodes()/100 != quiet_size/100) {
+        LOGGER_WRITE(Logger::INFO, VAR_PRINT(network.size_in_nodes()))
+        quiet_size = network.size_in_nodes();
+      }
+    #endif
+    if (on_batch) on_batch(network);
+  }
+  return;
+}
+
+/*  The loops are specialized on the link handling mode and on the basic size of the network
+ *  (see the kernels of spa_network_t), and selected once per simulation by dispatch().
+ *  s = 0 stands for any basic size.
+ */
+template <link_mode_t links, unsigned int s>
+struct spa_star_kernel {
+  template <typename engine_t> static void run(double p, double q, double r, spa_network_t & network, draw_buffer_t<engine_t> & draws, const batch_observer_t & on_batch);
+};
+template <link_mode_t links, unsigned int s>
+struct spa_basic_kernel {
+  template <typename engine_t> static void run(double p, double q, spa_network_t & network, draw_buffer_t<engine_t> & draws, const batch_observer_t & on_batch);
+};
+
+/** Run kernel_t<links, s>, with s the basic size if a specialization exists (0 otherwise). */
+template <template <link_mode_t, unsigned int> class kernel_t, link_mode_t links, typename... args_t>
+static void dispatch_size(size_t basic_size, args_t&&... args) {
+  switch (basic_size) {
+    case 1: return kernel_t<links, 1>::run(std::forward<args_t>(args)...);
+    case 2: return kernel_t<links, 2>::run(std::forward<args_t>(args)...);
+    case 3: return kernel_t<links, 3>::run(std::forward<args_t>(args)...);
+    default: return kernel_t<links, 0>::run(std::forward<args_t>(args)...);
+  }
+}
+/** Run the specialization of kernel_t that matches the link handling mode and the basic size of the network. */
+template <template <link_mode_t, unsigned int> class kernel_t, typename... args_t>
+static void dispatch(const spa_network_t & network, args_t&&... args) {
+  switch (network.link_mode()) {
+    case EXPLICIT_LINKS: return dispatch_size<kernel_t, EXPLICIT_LINKS>(network.basic_size(), std::forward<args_t>(args)...);
+    case DEFERRED_LINKS: return dispatch_size<kernel_t, DEFERRED_LINKS>(network.basic_size(), std::forward<args_t>(args)...);
+    default: return dispatch_size<kernel_t, LEGACY_LINKS>(network.basic_size(), std::forward<args_t>(args)...);
+  }
+}
+
+template <typename engine_t>
+void spa_star (double p, double q, double r, spa_network_t & network, engine_t& engine, const batch_observer_t & on_batch) {
+  draw_buffer_t<engine_t> draws(engine);
+  dispatch<spa_star_kernel>(network, p, q, r, network, draws, on_batch);
+  return;
+}
+template <typename engine_t>
+void spa_basic(double p, double q, spa_network_t & network, engine_t& engine, const batch_observer_t & on_batch) {
+  draw_buffer_t<engine_t> draws(engine);
+  dispatch<spa_basic_kernel>(network, p, q, network, draws, on_batch);
+  return;
+}
+
+template <link_mode_t links, unsigned int s> template <typename engine_t>
+void spa_star_kernel<links, s>::run(double p, double q, double r, spa_network_t & network, draw_buffer_t<engine_t> & draws, const batch_observer_t & on_batch) {
   bool new_individual;
-  std::uniform_real_distribution<double> rand_real(0,1);
-  unsigned int quiet_size = 0;
+  if (!reference_arithmetic<engine_t>::value) return spa_scheduled<links, s>(p, q, r*(1-p), network, draws, on_batch);
+  const probability_t birth(p), new_node(q), link_creation(r*(1-p));
+  size_t batch_events = 0;
+  #if LOGGER_LEVEL < 3
+    unsigned int quiet_size = 0;
+  #endif
   if (r*(1-p) >= 1) {
     LOGGER_WRITE(Logger::DEBUG,VAR_PRINT(r*(1-p))+" >= 1 : Links are occuring on a faster time-scale.")
     /** In this case, link occur on a fast time scale. 
@@ -27,31 +120,35 @@ void spa_star (double p, double q, double r, spa_network_t & network, std::mt199
     std::geometric_distribution<int> geo_real(epsilon);
     while (network.size_in_nodes()<network.target_size()) {
       // create links due to steps where no cluster related event happen.  
-      unsigned int number_of_link_creation_steps = geo_real(engine); 
+      unsigned int number_of_link_creation_steps = geo_real(draws); 
       LOGGER_WRITE(Logger::DEBUG, "Geometric distribution result: "+VAR_EVAL(number_of_link_creation_steps)+" additional links must be created.")
       for (unsigned int i = 0; i < number_of_link_creation_steps; ++i) {
         LOGGER_WRITE(Logger::DEBUG, "link_creation_step:")
-        auto event_ret = network.link_creation_step(engine);
+        auto event_ret = network.link_kernel<links>(draws);
         LOGGER_WRITE(Logger::DEBUG,"\tSUCCESS ? "+VAR_EVAL(std::get<3>(event_ret))+" || "+VAR_EVAL(std::get<0>(event_ret))+"<->"+VAR_EVAL(std::get<1>(event_ret))+" in cluster "+VAR_EVAL(std::get<2>(event_ret)))
+        (void) event_ret;
       }
 
       // test for cluster birth or growth
-      if (rand_real(engine) < p) {
-        rand_real(engine) < q ?  new_individual = true : new_individual = false;
+      if (draws.bernoulli(birth)) {
+        new_individual = draws.bernoulli(new_node);
         LOGGER_WRITE(Logger::DEBUG, "cluster_birth with"+VAR_PRINT(new_individual))
-        id_t event_ret = network.cluster_birth(new_individual,engine);
+        id_t event_ret = network.birth_kernel<links, s>(new_individual,draws);
         LOGGER_WRITE(Logger::DEBUG, "\tcluster="+VAR_EVAL(event_ret))
+        (void) event_ret;
       } 
       else { 
-        rand_real(engine) < q ?  new_individual = true : new_individual = false;
+        new_individual = draws.bernoulli(new_node);
         LOGGER_WRITE(Logger::DEBUG, "cluster_growth with "+VAR_PRINT(new_individual))
-        auto event_ret = network.cluster_growth(new_individual,engine);
+        auto event_ret = network.growth_kernel<links>(new_individual,draws);
         LOGGER_WRITE(Logger::DEBUG,"\tnode="+VAR_EVAL(std::get<0>(event_ret))+" cluster="+VAR_EVAL(std::get<1>(event_ret)))
+        (void) event_ret;
       }
       // normal link creation step
       LOGGER_WRITE(Logger::DEBUG, "link_creation_step:")
-      auto event_ret = network.link_creation_step(engine);
+      auto event_ret = network.link_kernel<links>(draws);
       LOGGER_WRITE(Logger::DEBUG,"\tSUCCESS ? "+VAR_EVAL(std::get<3>(event_ret))+" || "+VAR_EVAL(std::get<0>(event_ret))+"<->"+VAR_EVAL(std::get<1>(event_ret))+" in cluster "+VAR_EVAL(std::get<2>(event_ret)))
+      (void) event_ret;
 
       LOGGER_WRITE(Logger::DEBUG,"===============================")
       LOGGER_WRITE(Logger::DEBUG, "Current size:"+VAR_PRINT(network.size_in_nodes()))
@@ -61,6 +158,11 @@ void spa_star (double p, double q, double r, spa_network_t & network, std::mt199
           quiet_size = network.size_in_nodes();
         }
       #endif
+      // batch boundary (same period as the scheduler)
+      if (++batch_events == spa_scheduler_t<engine_t>::block_size) {
+        batch_events = 0;
+        if (on_batch) on_batch(network);
+      }
     }
   }
   else {
@@ -76,23 +178,26 @@ void spa_star (double p, double q, double r, spa_network_t & network, std::mt199
       */
     while (network.size_in_nodes()<network.target_size()) {
       // test for cluster birth/growth
-      if (rand_real(engine) < p) {
-        rand_real(engine) < q ?  new_individual = true : new_individual = false;
+      if (draws.bernoulli(birth)) {
+        new_individual = draws.bernoulli(new_node);
         LOGGER_WRITE(Logger::DEBUG, "cluster_birth with"+VAR_PRINT(new_individual))
-        id_t event_ret = network.cluster_birth(new_individual,engine);
+        id_t event_ret = network.birth_kernel<links, s>(new_individual,draws);
         LOGGER_WRITE(Logger::DEBUG, "\tcluster="+VAR_EVAL(event_ret))
+        (void) event_ret;
       } 
       else {
-        rand_real(engine) < q ?  new_individual = true : new_individual = false;
+        new_individual = draws.bernoulli(new_node);
         LOGGER_WRITE(Logger::DEBUG, "cluster_growth with "+VAR_PRINT(new_individual))
-        auto event_ret = network.cluster_growth(new_individual,engine);
+        auto event_ret = network.growth_kernel<links>(new_individual,draws);
         LOGGER_WRITE(Logger::DEBUG,"\tnode="+VAR_EVAL(std::get<0>(event_ret))+" cluster="+VAR_EVAL(std::get<1>(event_ret)))
+        (void) event_ret;
       }
       // test for link creation
-      if (rand_real(engine)<r*(1-p)) {
+      if (draws.bernoulli(link_creation)) {
         LOGGER_WRITE(Logger::DEBUG, "link_creation_step:")
-        auto event_ret = network.link_creation_step(engine);
+        auto event_ret = network.link_kernel<links>(draws);
         LOGGER_WRITE(Logger::DEBUG,"\tSUCCESS ? "+VAR_EVAL(std::get<3>(event_ret))+" || "+VAR_EVAL(std::get<0>(event_ret))+"<->"+VAR_EVAL(std::get<1>(event_ret))+" in cluster "+VAR_EVAL(std::get<2>(event_ret)))
+        (void) event_ret;
       }
 
       LOGGER_WRITE(Logger::DEBUG,"===============================")
@@ -103,28 +208,40 @@ void spa_star (double p, double q, double r, spa_network_t & network, std::mt199
           quiet_size = network.size_in_nodes();
         }
       #endif
+      // batch boundary (same period as the scheduler)
+      if (++batch_events == spa_scheduler_t<engine_t>::block_size) {
+        batch_events = 0;
+        if (on_batch) on_batch(network);
+      }
     }
   }
   return;
 }
-void spa_basic(double p, double q, spa_network_t & network, std::mt19937& engine) {
+template <link_mode_t links, unsigned int s> template <typename engine_t>
+void spa_basic_kernel<links, s>::run(double p, double q, spa_network_t & network, draw_buffer_t<engine_t> & draws, const batch_observer_t & on_batch) {
   bool new_individual;
-  std::uniform_real_distribution<double> rand_real(0,1);
-  unsigned int quiet_size = 0;
+  if (!reference_arithmetic<engine_t>::value) return spa_scheduled<links, s>(p, q, 0, network, draws, on_batch);
+  const probability_t birth(p), new_node(q);
+  size_t batch_events = 0;
+  #if LOGGER_LEVEL < 3
+    unsigned int quiet_size = 0;
+  #endif
   // untill the desired size is reached...
   while (network.size_in_nodes()<network.target_size()) {
     // test for cluster birth or growth
-    if (rand_real(engine) < p) {
-      rand_real(engine) < q ?  new_individual = true : new_individual = false;
+    if (draws.bernoulli(birth)) {
+      new_individual = draws.bernoulli(new_node);
       LOGGER_WRITE(Logger::DEBUG, "cluster_birth with"+VAR_PRINT(new_individual))
-      id_t event_ret = network.cluster_birth(new_individual,engine);
+      id_t event_ret = network.birth_kernel<links, s>(new_individual,draws);
       LOGGER_WRITE(Logger::DEBUG, "\tcluster="+VAR_EVAL(event_ret))
+      (void) event_ret;
     } 
     else { 
-      rand_real(engine) < q ?  new_individual = true : new_individual = false;
+      new_individual = draws.bernoulli(new_node);
       LOGGER_WRITE(Logger::DEBUG, "cluster_growth with "+VAR_PRINT(new_individual))
-      auto event_ret = network.cluster_growth(new_individual,engine);
+      auto event_ret = network.growth_kernel<links>(new_individual,draws);
       LOGGER_WRITE(Logger::DEBUG,"\tnode="+VAR_EVAL(std::get<0>(event_ret))+" cluster="+VAR_EVAL(std::get<1>(event_ret)))
+      (void) event_ret;
     }
 
     LOGGER_WRITE(Logger::DEBUG,"===============================")
@@ -135,6 +252,118 @@ void spa_basic(double p, double q, spa_network_t & network, std::mt19937& engine
           quiet_size = network.size_in_nodes();
         }
     #endif
+    // batch boundary (same period as the scheduler)
+    if (++batch_events == spa_scheduler_t<engine_t>::block_size) {
+      batch_events = 0;
+      if (on_batch) on_batch(network);
+    }
+  }
+  return;
+}
+void spa_relaxed(double p, double q, double r, spa_network_t & network, uint32_t seed, uint32_t realization, unsigned int threads, double tolerance, const batch_observer_t & on_batch) {
+  assert(network.link_mode() != EXPLICIT_LINKS);
+  const size_t s = network.basic_size();
+  philox4x32_t engine(seed, realization, RELAXED_PHASE, 0);
+  draw_buffer_t<philox4x32_t> draws(engine);
+  spa_scheduler_t<philox4x32_t> scheduler(p, q, network.link_mode() == DEFERRED_LINKS ? r*(1-p) : 0, draws);
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::vector<spa_event_t> epoch;
+  std::vector<size_t> offsets; // the picks of event i are picks[offsets[i]], ..., picks[offsets[i+1]-1]
+  std::vector<id_t> picks;
+  std::vector<id_t> content(s);
+  const std::vector<spa_event_t> * block = &scheduler.next_block();
+  size_t cursor = 0;
+  uint32_t first_chunk = 0;
+  #if LOGGER_LEVEL < 3
+    unsigned int quiet_size = 0;
+  #endif
+  while (network.size_in_nodes()<network.target_size()) {
+    /* Decisions of the epoch, up to the event that completes the network */
+    size_t length = (size_t) (tolerance * network.get_incidence_sum() / s);
+    length = std::min(std::max(length, (size_t) 1), relaxed_max_epoch);
+    const size_t missing_nodes = network.target_size() - network.size_in_nodes();
+    size_t new_nodes = 0;
+    epoch.clear();
+    offsets.assign(1, 0);
+    while (epoch.size() < length && new_nodes < missing_nodes) {
+      if (cursor == block->size()) {
+        block = &scheduler.next_block();
+        cursor = 0;
+      }
+      const spa_event_t & event = (*block)[cursor++];
+      size_t event_picks = event.links_before + (event.link_after ? 1 : 0);
+      if (event.birth) event_picks += event.new_individual ? s - 1 : s;
+      else event_picks += event.new_individual ? 1 : 2;
+      epoch.push_back(event);
+      offsets.push_back(offsets.back() + event_picks);
+      if (event.new_individual) ++new_nodes;
+    }
+
+    /* Picks, against the state of the network at the beginning of the epoch */
+    picks.resize(offsets.back());
+    const size_t chunks = (epoch.size() + relaxed_chunk_size - 1) / relaxed_chunk_size;
+    auto draw_chunk = [&](size_t chunk) {
+      philox4x32_t stream(seed, realization, RELAXED_PHASE, 1 + first_chunk + (uint32_t) chunk);
+      draw_buffer_t<philox4x32_t> chunk_draws(stream);
+      const size_t last = std::min(epoch.size(), (chunk + 1) * relaxed_chunk_size);
+      for (size_t i = chunk * relaxed_chunk_size; i < last; ++i) {
+        const spa_event_t & event = epoch[i];
+        id_t * pick = picks.data() + offsets[i];
+        for (uint64_t l = 0; l < event.links_before; ++l) *pick++ = network.snapshot_pick_cluster(chunk_draws);
+        if (event.birth) {
+          for (size_t j = 0; j + 1 < s; ++j) *pick++ = network.snapshot_pick_node(chunk_draws);
+          if (!event.new_individual) *pick++ = network.snapshot_pick_node(chunk_draws);
+        }
+        else {
+          *pick++ = network.snapshot_pick_cluster(chunk_draws);
+          if (!event.new_individual) *pick++ = network.snapshot_pick_node(chunk_draws);
+        }
+        if (event.link_after) *pick++ = network.snapshot_pick_cluster(chunk_draws);
+      }
+    };
+    if (threads > 1 && epoch.size() >= relaxed_parallel_epoch) {
+      std::atomic<size_t> next(0);
+      std::vector<std::thread> pool;
+      for (size_t t = 0; t < std::min((size_t) threads, chunks); ++t) {
+        pool.emplace_back([&]() { for (size_t chunk = next++; chunk < chunks; chunk = next++) draw_chunk(chunk); });
+      }
+      for (auto it = pool.begin(); it != pool.end(); ++it) it->join();
+    }
+    else for (size_t chunk = 0; chunk < chunks; ++chunk) draw_chunk(chunk);
+    first_chunk += (uint32_t) chunks;
+
+    /* Events, in order */
+    for (size_t i = 0; i < epoch.size(); ++i) {
+      const spa_event_t & event = epoch[i];
+      const id_t * pick = picks.data() + offsets[i];
+      for (uint64_t l = 0; l < event.links_before; ++l) network.commit_link(*pick++);
+      if (event.birth) {
+        const size_t picked = event.new_individual ? s - 1 : s;
+        std::copy(pick, pick + picked, content.begin());
+        network.commit_birth(content.data(), event.new_individual);
+        pick += picked;
+      }
+      else {
+        network.commit_growth(event.new_individual ? 0 : pick[1], pick[0], event.new_individual);
+        pick += event.new_individual ? 1 : 2;
+      }
+      if (event.link_after) network.commit_link(*pick++);
+    }
+    LOGGER_WRITE(Logger::DEBUG, "End of epoch, "+VAR_PRINT(epoch.size())+" events, current size:"+VAR_PRINT(network.size_in_nodes()))
+    #if LOGGER_LEVEL < 3 
+      if (network.size_in_nodes()/100 != quiet_size/100) {
+        LOGGER_WRITE(Logger::INFO, VAR_PRINT(network.size_in_nodes()))
+        quiet_size = network.size_in_nodes();
+      }
+    #endif
+    if (on_batch) on_batch(network);
   }
   return;
-}
\ No newline at end of file
+}
+
+// Explicit instantiations ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+#define INSTANTIATE_SPA_ALGORITHM(ENGINE) \
+  template void spa_star<ENGINE>(double, double, double, spa_network_t &, ENGINE&, const batch_observer_t &); \
+  template void spa_basic<ENGINE>(double, double, spa_network_t &, ENGINE&, const batch_observer_t &);
+SPA_FOR_EACH_ENGINE(INSTANTIATE_SPA_ALGORITHM)
@@ -3,17 +3,58 @@
 
 // Configuration file
 #include "config.h"
+// C libraries
+#include <stdint.h> // uint32_t
 // STL
-#include <random>   //std::uniform_real_distribution and std::geometric_distribution
+#include <random>   // std::geometric_distribution
 #include <tuple>    // return type for event 
+#include <functional> // batch_observer_t
 // Project files
 #include "spa_network.hpp" // spa_network_t
+#include "rng_engines.hpp" // engine types
+#include "draw_buffer.hpp" // draw_buffer_t, probability_t
+#include "spa_scheduler.hpp" // spa_scheduler_t
 // Typdef and helpers
 #include "includes/logger.hpp" // LOGGER macros
 #include "types.hpp" // id_t
 
 
-void spa_star (double p, double q, double r, spa_network_t & network, std::mt19937& engine);
-void spa_basic(double p, double q, spa_network_t & network, std::mt19937& engine);
+/*  The drivers are templates over the pseudo-RNG engine, instantiated for every 
+ *  engine of rng_engines.hpp. Every random decision is drawn from a single 
+ *  draw_buffer_t that wraps the engine for the duration of the simulation.
+ *
+ *  The decisions are drawn by blocks (see spa_scheduler.hpp), except for the 
+ *  reference engine (std::mt19937), which keeps the event by event loop of the
+ *  previous versions for reproducibility. 
+ */
+
+/// Called at every batch boundary, i.e. between two blocks of structural events, with the network in a consistent state.
+typedef std::function<void(const spa_network_t &)> batch_observer_t;
+
+template <typename engine_t> void spa_star (double p, double q, double r, spa_network_t & network, engine_t& engine, const batch_observer_t & on_batch = batch_observer_t());
+template <typename engine_t> void spa_basic(double p, double q, spa_network_t & network, engine_t& engine, const batch_observer_t & on_batch = batch_observer_t());
+
+/*  Relaxed-consistency growth. The events are processed by epochs: the preferential
+ *  picks of all the events of an epoch are drawn against the state of the network at
+ *  the beginning of the epoch, by up to @p threads threads, and the events are then 
+ *  committed in order, by the calling thread.
+ *
+ *  Deviation from the sequential process: a pick may miss the tickets added during 
+ *  its epoch (at most basic_size() per structural event, new nodes and clusters
+ *  included), i.e. at most Delta = length * basic_size() tickets out of the incidence
+ *  sum I. The total variation distance between the law of a relaxed pick and the law 
+ *  of the sequential pick is then at most Delta / I. Epochs are as long as possible 
+ *  under the bound Delta / I <= tolerance, hence the distance is at most 
+ *  max(tolerance, basic_size() / I): they are short while the network is small, and 
+ *  long (up to 65536 structural events) once it is large. The decisions of the 
+ *  events (birth, new node, link creation steps) follow the sequential law exactly.
+ *
+ *  The picks are drawn by chunks of 256 events, from the streams 
+ *  philox4x32_t(seed, realization, RELAXED_PHASE, 1 + chunk), and the decisions from 
+ *  philox4x32_t(seed, realization, RELAXED_PHASE, 0): the network does not depend on the 
+ *  number of threads. Links must be handled in deferred mode, or not at 
+ *  all (in which case @p r is ignored).
+ */
+void spa_relaxed(double p, double q, double r, spa_network_t & network, uint32_t seed, uint32_t realization, unsigned int threads, double tolerance, const batch_observer_t & on_batch = batch_observer_t());
 
 #endif //SPA_ALGORITHM_HPP
\ No newline at end of file
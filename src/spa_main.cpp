@@ -26,6 +26,10 @@
 // STL
 #include <string>   // const char* to std::string()
 #include <chrono>   // c++11, benchmarking
+#include <vector>   // realizations of a batch
+#include <memory>   // std::unique_ptr (manifest, statistics)
+#include <fstream>  // statistics files (distributed driver)
+#include <functional> // std::function (realize_batch(5))
 // boost
 #if HAVE_LIBBOOST_PROGRAM_OPTIONS == 1
   #include <boost/program_options.hpp>
@@ -34,15 +38,243 @@
 #include "spa_network.hpp" // spa_network_t
 #include "interface.hpp"  // boost_interface(3) and barbone_interface(3)
 #include "output_functions.hpp"  // print_outputs(2)
-#include "spa_algorithm.hpp" // spa_star(5) and spa_basic(4)
+#include "misc_functions.hpp" // compare_realizations(2), summarize_network(2)
+#include "spa_algorithm.hpp" // spa_star(5), spa_basic(4) and spa_relaxed(9)
+#include "rng_engines.hpp" // xoshiro256pp_t, pcg64_t, philox4x32_t
+#include "thread_pool.hpp" // thread_pool_t, memory_budget_t (ensemble and sweep modes)
+#include "sweep.hpp" // plan_batch(2), estimated_footprint(1), sweep_manifest_t, sweep_fingerprint(1)
+#if HAVE_MPI == 1
+  #include "spa_mpi.hpp" // mpi_session_t, realize_distributed(6)
+#endif
 // Typdef and helpers
 #include "types.hpp" // spa_parameters_t
 #include "errors.hpp" // detailed error code 
 #include "includes/logger.hpp" // LOGGER macros
 
+/** Setup and simulation, with the algorithm that matches the requested outputs.
+  * @param[in] <prog_params> Parsed program parameters.
+  * @param[in,out] <network> Empty network.
+  * @param[in,out] <engine> Initialized pseudo-RNG engine (see rng_engines.hpp).
+  * @param[in] <relaxed> Relaxed-consistency growth (spa_relaxed), instead of the sequential drivers.
+  */
+template <typename engine_t>
+void simulate(const spa_parameters_t & prog_params, spa_network_t & network, engine_t & engine, bool relaxed) {
+  if (prog_params.links_requested()) {
+    LOGGER_WRITE(Logger::INFO, "Connectivity information requested: complete simulation mode.")
+    if (prog_params.deferred_links.value || relaxed) network.set_deferred_links_status(true);
+    network.initialize(prog_params.initial_size.value);
+    if (relaxed) spa_relaxed(prog_params.p.value, prog_params.q.value, prog_params.r.value, network, prog_params.seed.value, prog_params.realization.value, prog_params.threads.value, prog_params.relaxed.value);
+    else spa_star(prog_params.p.value, prog_params.q.value, prog_params.r.value, network, engine);
+    if (network.link_mode() == DEFERRED_LINKS) {
+      LOGGER_WRITE(Logger::INFO, "Deferred link handling: building the subgraphs.")
+      network.materialize_subgraphs(prog_params.seed.value, prog_params.realization.value, prog_params.threads.value);
+    }
+  }
+  else if (prog_params.connected_edge_list.initialized || prog_params.connected_degrees.initialized) {
+    LOGGER_WRITE(Logger::INFO, "Legacy connectivity information requested: legacy simulation mode.")
+    network.set_handle_links_status(false);
+    network.initialize(prog_params.initial_size.value);
+    if (relaxed) spa_relaxed(prog_params.p.value, prog_params.q.value, 0, network, prog_params.seed.value, prog_params.realization.value, prog_params.threads.value, prog_params.relaxed.value);
+    else spa_basic(prog_params.p.value, prog_params.q.value, network, engine);
+  }
+  else {
+    LOGGER_WRITE(Logger::INFO, "No connectivity information requested: legacy simulation mode.")
+    network.set_handle_links_status(false);
+    network.initialize(prog_params.initial_size.value);
+    if (relaxed) spa_relaxed(prog_params.p.value, prog_params.q.value, 0, network, prog_params.seed.value, prog_params.realization.value, prog_params.threads.value, prog_params.relaxed.value);
+    else spa_basic(prog_params.p.value, prog_params.q.value, network, engine);
+  }
+  return;
+}
+/** Simulation of the requested realization and, in validation mode, of a sequential reference realization.
+  * @param[in] <prog_params> Parsed program parameters.
+  * @param[in,out] <network> Empty network.
+  * @param[in,out] <engine> Initialized pseudo-RNG engine (see rng_engines.hpp).
+  */
+template <typename engine_t>
+void run(const spa_parameters_t & prog_params, spa_network_t & network, engine_t & engine) {
+  if (prog_params.relaxed.value > 0) {LOGGER_WRITE(Logger::INFO, "Relaxed-consistency growth with tolerance "+VAR_EVAL(prog_params.relaxed.value)+".")}
+  simulate(prog_params, network, engine, prog_params.relaxed.value > 0);
+  if (prog_params.validate_relaxed.value) {
+    // the relaxed growth only draws from its own streams: the engine is still unused
+    LOGGER_WRITE(Logger::INFO, "Validation: growth of a sequential reference realization.")
+    spa_network_t reference(prog_params.final_size.value, prog_params.basic_size.value);
+    simulate(prog_params, reference, engine, false);
+    if (compare_realizations(network, reference)) {LOGGER_WRITE(Logger::CONFIG, "Validation: the relaxed realization is consistent with the sequential one.")}
+    else {LOGGER_WRITE(Logger::CONFIG, "Validation: the relaxed realization is NOT consistent with the sequential one, lower the tolerance.")}
+  }
+  return;
+}
+
+/** One realization: simulation, then outputs.
+  * @param[in] <prog_params> Parsed program parameters.
+  * @param[out] <summary> Statistics of the realization, if not null (distributed driver).
+  */
+void realize(const spa_parameters_t & prog_params, network_summary_t * summary = nullptr) {
+  // Object declarations
+  #if HAVE_STEADY_CLOCK == 1
+    const auto simulation_begins = std::chrono::steady_clock::now();
+  #else 
+    const auto simulation_begins = std::chrono::monotonic_clock::now();
+  #endif
+
+  LOGGER_WRITE(Logger::DEBUG, "Instantiation of the spa_network_t class.")
+  spa_network_t network(prog_params.final_size.value, prog_params.basic_size.value);
+
+  // every engine is keyed by the pair (seed, realization), and realization 0 is seeded with the seed alone
+  LOGGER_WRITE(Logger::DEBUG, "Instantiation of the random number generator engine "+VAR_PRINT(prog_params.engine.value)+" with "+VAR_PRINT(prog_params.seed.value)+" and "+VAR_PRINT(prog_params.realization.value)+".")
+  if (prog_params.engine.value == "xoshiro256pp") {
+    xoshiro256pp_t engine(realization_key(prog_params.seed.value, prog_params.realization.value));
+    run(prog_params, network, engine);
+  }
+  else if (prog_params.engine.value == "pcg64") {
+    pcg64_t engine(realization_key(prog_params.seed.value, prog_params.realization.value));
+    run(prog_params, network, engine);
+  }
+  else if (prog_params.engine.value == "philox") {
+    philox4x32_t engine(prog_params.seed.value, prog_params.realization.value, SIMULATION_PHASE);
+    run(prog_params, network, engine);
+  }
+  else {
+    std::mt19937 engine(prog_params.seed.value);
+    if (prog_params.realization.value > 0) {
+      std::seed_seq key{prog_params.seed.value, prog_params.realization.value};
+      engine.seed(key);
+    }
+    run(prog_params, network, engine);
+  }
+  LOGGER_WRITE(Logger::INFO, "Simulation completed.")
+  LOGGER_WRITE(Logger::INFO, "Memory arena high-water mark: "+VAR_EVAL(network.get_arena().high_water_mark())+" bytes ("+VAR_EVAL(network.get_arena().bytes_reserved())+" bytes reserved).")
+
+  // Timer 
+  #if HAVE_STEADY_CLOCK == 1
+    const auto simulation_ends = std::chrono::steady_clock::now();
+  #else 
+    const auto simulation_ends = std::chrono::monotonic_clock::now();
+  #endif
+  double simulation_duration = std::chrono::duration_cast<std::chrono::milliseconds>(simulation_ends-simulation_begins).count()/1000.0;
+  if (summary != nullptr) *summary = summarize_network(network, simulation_duration);
+
+  // Outputs
+  LOGGER_WRITE(Logger::INFO, "Processing outputs.")
+  process_and_output(network, prog_params, simulation_duration); // this alters the network.
+  return;
+}
+/** Realizations on a thread pool, within the memory budget (ensemble and sweep modes).
+  * @param[in] <batch> Planned realizations.
+  * @param[in] <tasks> Indices of the realizations to run, started in order when threads are available.
+  * @param[in] <threads> Number of threads (0: one per core).
+  * @param[in] <memory_limit> Memory budget in MB (0: three quarters of the physical memory).
+  * @param[in] <on_completion> Called with the index of each realization once its outputs are written.
+  */
+void realize_batch(const realization_batch_t & batch, const std::vector<size_t> & tasks, unsigned int threads, unsigned int memory_limit, const std::function<void(size_t)> & on_completion) {
+  thread_pool_t pool(threads);
+  memory_budget_t memory((size_t) memory_limit << 20);
+  LOGGER_WRITE(Logger::CONFIG, "Batch of "+VAR_EVAL(tasks.size())+" realizations on "+VAR_EVAL(pool.size())+" threads, within a budget of "+VAR_EVAL(memory.capacity())+" bytes.")
+  for (auto it = tasks.begin(); it != tasks.end(); ++it) {
+    const size_t task = *it;
+    pool.submit([&batch, &memory, &on_completion, task]() {
+      const spa_parameters_t & params = batch.params[task];
+      const size_t footprint = estimated_footprint(params);
+      memory.acquire(footprint);
+      LOGGER_WRITE(Logger::CONFIG, "Realization "+VAR_EVAL(task)+": seed "+VAR_EVAL(params.seed.value)+", realization "+VAR_EVAL(params.realization.value)+", base path "+params.base_path.value+", "+VAR_EVAL(footprint)+" bytes (estimate).")
+      try {
+        realize(params);
+      }
+      catch (...) {
+        memory.release(footprint);
+        throw;
+      }
+      memory.release(footprint);
+      on_completion(task);
+    });
+  }
+  pool.run();
+  return;
+}
+/** Ensemble (-k) and sweep (-w) modes: realizations of the planned batch, skipping the
+  * realizations of a sweep that are recorded in its manifest.
+  * @param[in] <prog_params> Parsed program parameters.
+  */
+void realize_concurrently(const spa_parameters_t & prog_params) {
+  realization_batch_t batch;
+  plan_batch(prog_params, batch);
+  std::unique_ptr<sweep_manifest_t> manifest;
+  if (prog_params.sweep.initialized) manifest.reset(new sweep_manifest_t(sweep_manifest_path(prog_params), sweep_fingerprint(prog_params)));
+  std::vector<size_t> tasks;
+  for (size_t task = 0; task < batch.params.size(); ++task) {
+    if (!manifest || !manifest->completed(batch.labels[task])) tasks.push_back(task);
+  }
+  if (manifest) {LOGGER_WRITE(Logger::CONFIG, "Sweep: "+VAR_EVAL(batch.params.size() - tasks.size())+" of "+VAR_EVAL(batch.params.size())+" realizations already completed (see the manifest).")}
+  realize_batch(batch, tasks, prog_params.threads.value, prog_params.memory_limit.value, [&manifest, &batch](size_t task) {
+    if (manifest) manifest->record(batch.labels[task]);
+  });
+  return;
+}
+#if HAVE_MPI == 1
+/** Distributed driver: realizations of the planned batch (a single one without -k or -w) across the
+  * ranks, skipping the realizations of a sweep that are recorded in its manifest. The statistics of
+  * the realizations are appended to realization_statistics.txt, and reduced to their mean and standard
+  * deviation over the realizations of each point in aggregate_statistics.txt (in the base path).
+  * @param[in] <prog_params> Parsed program parameters.
+  * @param[in] <session> MPI session (at least 2 ranks).
+  * @return Number of realizations that failed (first rank), 0 (other ranks).
+  */
+size_t realize_on_ranks(const spa_parameters_t & prog_params, const mpi_session_t & session) {
+  // every rank plans the same batch: the streams do not depend on the ranks
+  realization_batch_t batch;
+  plan_batch(prog_params, batch);
+  std::vector<size_t> tasks;
+  std::unique_ptr<sweep_manifest_t> manifest;
+  std::unique_ptr<std::ofstream> statistics;
+  const std::string statistics_path = prog_params.base_path.value + "realization_statistics.txt";
+  if (session.rank() == 0) {
+    if (prog_params.sweep.initialized) manifest.reset(new sweep_manifest_t(sweep_manifest_path(prog_params), sweep_fingerprint(prog_params)));
+    for (size_t task = 0; task < batch.params.size(); ++task) {
+      if (!manifest || !manifest->completed(batch.labels[task])) tasks.push_back(task);
+    }
+    // a resumed sweep adds its realizations to the statistics of the previous runs
+    const bool resumed = tasks.size() < batch.params.size();
+    statistics.reset(new std::ofstream(statistics_path.c_str(), resumed ? std::ios::app : std::ios::out));
+    if (!resumed) {
+      *statistics << "# group label seed realization";
+      for (unsigned int field = 0; field < network_summary_t::FIELDS; ++field) *statistics << " " << network_summary_t::name(field);
+      *statistics << "\n";
+    }
+    LOGGER_WRITE(Logger::CONFIG, "Distribution of "+VAR_EVAL(tasks.size())+" of "+VAR_EVAL(batch.params.size())+" realizations on "+VAR_EVAL(session.size())+" ranks.")
+  }
+  const size_t failures = realize_distributed(session, batch, tasks, prog_params.threads.value,
+    [](const spa_parameters_t & params) {
+      network_summary_t summary;
+      realize(params, &summary);
+      return summary;
+    },
+    [&](size_t task, const network_summary_t & summary) {
+      // statistics first: a realization recorded in the manifest always has its statistics
+      output_realization_statistics(batch.groups[task], batch.labels[task], batch.params[task].seed.value, batch.params[task].realization.value, summary, *statistics);
+      statistics->flush();
+      if (manifest) manifest->record(batch.labels[task]);
+    });
+  if (session.rank() == 0) {
+    statistics->close();
+    std::ifstream realizations(statistics_path.c_str(), std::ios::in);
+    std::ofstream aggregate((prog_params.base_path.value + "aggregate_statistics.txt").c_str(), std::ios::out);
+    output_aggregate_statistics(realizations, aggregate);
+  }
+  return failures;
+}
+#endif
+
 int main(int argc, char const *argv[]) {
+  #if HAVE_MPI == 1
+    mpi_session_t session(argc, argv);
+  #endif
   
   LOGGER_START("")
+  #if HAVE_MPI == 1 && LOGGER_LEVEL < 3
+    // the first rank logs the parameters and the distribution, the others only their errors
+    if (session.rank() > 0) Logger::Start(Logger::ERROR, "");
+  #endif
 
   // Interface (parse argv, handle parameter errors, help message, etc.)
 
@@ -83,50 +315,20 @@ int main(int argc, char const *argv[]) {
     default: break;
   }
 
-  // Object declarations
-  #if HAVE_STEADY_CLOCK == 1
-    const auto simulation_begins = std::chrono::steady_clock::now();
-  #else 
-    const auto simulation_begins = std::chrono::monotonic_clock::now();
-  #endif
-
-  LOGGER_WRITE(Logger::DEBUG, "Instantiation of the spa_network_t class.")
-  spa_network_t network(prog_params.final_size.value, prog_params.basic_size.value);
-
-  LOGGER_WRITE(Logger::DEBUG, "Instantiation of the random number generator engine "+VAR_PRINT(prog_params.seed.value)+".")
-  std::mt19937 engine(prog_params.seed.value);
-
-  // Setup and simulation
-  if (prog_params.edge_list.initialized || prog_params.degrees.initialized || prog_params.internal_degrees.initialized || prog_params.projected_internal_degrees.initialized) {
-    LOGGER_WRITE(Logger::INFO, "Connectivity information requested: complete simulation mode.")
-    network.initialize(prog_params.initial_size.value);
-    spa_star(prog_params.p.value, prog_params.q.value, prog_params.r.value, network, engine);
-  }
-  else if (prog_params.connected_edge_list.initialized || prog_params.connected_degrees.initialized) {
-    LOGGER_WRITE(Logger::INFO, "Legacy connectivity information requested: legacy simulation mode.")
-    network.set_handle_links_status(false);
-    network.initialize(prog_params.initial_size.value);
-    spa_basic(prog_params.p.value, prog_params.q.value, network, engine);
-  }
-  else {
-    LOGGER_WRITE(Logger::INFO, "No connectivity information requested: legacy simulation mode.")
-    network.set_handle_links_status(false);
-    network.initialize(prog_params.initial_size.value);
-    spa_basic(prog_params.p.value, prog_params.q.value, network, engine);
-  }
-  LOGGER_WRITE(Logger::INFO, "Simulation completed.")
-
-  // Timer 
-  #if HAVE_STEADY_CLOCK == 1
-    const auto simulation_ends = std::chrono::steady_clock::now();
-  #else 
-    const auto simulation_ends = std::chrono::monotonic_clock::now();
+  #if HAVE_MPI == 1
+    if (session.size() > 1) {
+      if (realize_on_ranks(prog_params, session) > 0) {
+        LOGGER_WRITE(Logger::ERROR, "Exiting with errors: some realizations failed (see the log).")
+        LOGGER_STOP()
+        return EXIT_FAILURE;
+      }
+      LOGGER_WRITE(Logger::INFO, "Exiting without error.")
+      LOGGER_STOP()
+      return EXIT_SUCCESS;
+    }
   #endif
-  double simulation_duration = std::chrono::duration_cast<std::chrono::milliseconds>(simulation_ends-simulation_begins).count()/1000.0;
-
-  // Outputs
-  LOGGER_WRITE(Logger::INFO, "Processing outputs.")
-  process_and_output(network, prog_params, simulation_duration); // this alters the network.
+  if (prog_params.sweep.initialized || prog_params.realizations.value > 1) realize_concurrently(prog_params);
+  else realize(prog_params);
 
   LOGGER_WRITE(Logger::INFO, "Exiting without error.")
   LOGGER_STOP()
@@ -0,0 +1,150 @@
+#include "spa_mpi.hpp"
+
+// MPI (without the deprecated C++ bindings)
+#define OMPI_SKIP_MPICXX 1
+#define MPICH_SKIP_MPICXX 1
+#include <mpi.h>
+// C libraries
+#include <stdlib.h> // EXIT_FAILURE
+// STL
+#include <string>    // error messages
+#include <exception> // std::exception
+#include <iostream>  // std::cerr (thread support)
+#include <future>    // std::async (realizations of the first rank)
+#include <chrono>    // std::chrono::milliseconds
+// Logger
+#include "includes/logger.hpp" // LOGGER macros
+
+// Messages ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace {
+  /// Tag of every message of the driver.
+  const int TASK_TAG = 1;
+  /// Status of a report (first value of a report).
+  enum report_status_t {REQUEST = 0, COMPLETED = 1, FAILED = 2};
+  /// Report of a rank: status, task index, then the statistics of the realization.
+  const int REPORT_SIZE = 2 + network_summary_t::FIELDS;
+  /// Task index that stops a rank.
+  const long STOP = -1;
+  /// Polling period of the first rank while it runs a realization of its own.
+  const std::chrono::milliseconds POLLING_PERIOD(1);
+}
+
+// ============================================================================================
+// mpi_session_t ==============================================================================
+// ============================================================================================
+
+mpi_session_t::mpi_session_t(int & argc, const char ** & argv) : rank_(0), size_(1) {
+  // only the main thread of a rank calls MPI, the realizations may still use threads
+  int provided;
+  char ** args = const_cast<char **>(argv);
+  MPI_Init_thread(&argc, &args, MPI_THREAD_FUNNELED, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+  MPI_Comm_size(MPI_COMM_WORLD, &size_);
+  if (provided < MPI_THREAD_FUNNELED) {
+    // the logger is not started yet, and the other ranks may be waiting for this one
+    std::cerr << "ERROR: rank " << rank_ << ": the MPI library does not support threads (MPI_THREAD_FUNNELED), aborting.\n";
+    MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+  }
+}
+mpi_session_t::~mpi_session_t() {MPI_Finalize();}
+int mpi_session_t::rank() const {return rank_;}
+int mpi_session_t::size() const {return size_;}
+
+// ============================================================================================
+// PUBLIC =====================================================================================
+// ============================================================================================
+
+size_t realize_distributed(const mpi_session_t & session, const realization_batch_t & batch, const std::vector<size_t> & tasks, unsigned int threads, const realize_t & realize, const completion_t & on_completion) {
+  double report[REPORT_SIZE];
+  size_t failures = 0;
+  if (session.rank() == 0) {
+    // dealer: answer each report with the next task, until every rank is stopped, and run a
+    // realization of its own on another thread meanwhile (only the main thread calls MPI)
+    size_t next = 0;
+    int active = session.size() - 1;
+    long local_task = STOP;
+    std::future<network_summary_t> local;
+    auto deal_locally = [&]() {
+      local_task = STOP;
+      if (next < tasks.size()) {
+        local_task = (long) tasks[next++];
+        LOGGER_WRITE(Logger::CONFIG, "Realization "+VAR_EVAL(local_task)+" on rank 0: seed "+VAR_EVAL(batch.params[local_task].seed.value)+", realization "+VAR_EVAL(batch.params[local_task].realization.value)+", base path "+batch.params[local_task].base_path.value+".")
+        spa_parameters_t params = batch.params[local_task];
+        params.threads.value = threads;
+        local = std::async(std::launch::async, realize, params);
+      }
+    };
+    deal_locally();
+    while (active > 0 || local_task != STOP) {
+      if (local_task != STOP && (active == 0 || local.wait_for(POLLING_PERIOD) == std::future_status::ready)) {
+        try {
+          on_completion((size_t) local_task, local.get());
+        }
+        catch (const std::exception & error) {
+          ++failures;
+          LOGGER_WRITE(Logger::ERROR, "Realization "+VAR_EVAL(local_task)+" ("+batch.labels[local_task]+") failed on rank 0: "+std::string(error.what()))
+        }
+        catch (...) {
+          ++failures;
+          LOGGER_WRITE(Logger::ERROR, "Realization "+VAR_EVAL(local_task)+" ("+batch.labels[local_task]+") failed on rank 0.")
+        }
+        deal_locally();
+        continue;
+      }
+      MPI_Status status;
+      if (local_task != STOP) {
+        // the realization of the first rank is still running
+        int pending = 0;
+        MPI_Iprobe(MPI_ANY_SOURCE, TASK_TAG, MPI_COMM_WORLD, &pending, &status);
+        if (!pending) continue;
+      }
+      MPI_Recv(report, REPORT_SIZE, MPI_DOUBLE, MPI_ANY_SOURCE, TASK_TAG, MPI_COMM_WORLD, &status);
+      const size_t completed = (size_t) report[1];
+      if (report[0] == COMPLETED) {
+        network_summary_t summary;
+        for (unsigned int field = 0; field < network_summary_t::FIELDS; ++field) summary.values[field] = report[2 + field];
+        on_completion(completed, summary);
+      }
+      else if (report[0] == FAILED) {
+        ++failures;
+        LOGGER_WRITE(Logger::ERROR, "Realization "+VAR_EVAL(completed)+" ("+batch.labels[completed]+") failed on rank "+VAR_EVAL(status.MPI_SOURCE)+".")
+      }
+      long task = STOP;
+      if (next < tasks.size()) {
+        task = (long) tasks[next++];
+        LOGGER_WRITE(Logger::CONFIG, "Realization "+VAR_EVAL(task)+" on rank "+VAR_EVAL(status.MPI_SOURCE)+": seed "+VAR_EVAL(batch.params[task].seed.value)+", realization "+VAR_EVAL(batch.params[task].realization.value)+", base path "+batch.params[task].base_path.value+".")
+      }
+      else --active;
+      MPI_Send(&task, 1, MPI_LONG, status.MPI_SOURCE, TASK_TAG, MPI_COMM_WORLD);
+    }
+  }
+  else {
+    report[0] = REQUEST;
+    report[1] = 0;
+    for (unsigned int field = 0; field < network_summary_t::FIELDS; ++field) report[2 + field] = 0;
+    while (true) {
+      MPI_Send(report, REPORT_SIZE, MPI_DOUBLE, 0, TASK_TAG, MPI_COMM_WORLD);
+      long task;
+      MPI_Recv(&task, 1, MPI_LONG, 0, TASK_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      if (task == STOP) break;
+      // a rank runs one realization at a time: its parallel steps may use the threads of the rank
+      spa_parameters_t params = batch.params[task];
+      params.threads.value = threads;
+      report[1] = (double) task;
+      try {
+        const network_summary_t summary = realize(params);
+        report[0] = COMPLETED;
+        for (unsigned int field = 0; field < network_summary_t::FIELDS; ++field) report[2 + field] = summary.values[field];
+      }
+      catch (const std::exception & error) {
+        report[0] = FAILED;
+        LOGGER_WRITE(Logger::ERROR, "Realization "+VAR_EVAL(task)+" failed: "+std::string(error.what()))
+      }
+      catch (...) {
+        report[0] = FAILED;
+        LOGGER_WRITE(Logger::ERROR, "Realization "+VAR_EVAL(task)+" failed.")
+      }
+    }
+  }
+  return failures;
+}
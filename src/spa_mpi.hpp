@@ -0,0 +1,65 @@
+#ifndef SPA_MPI_HPP
+#define SPA_MPI_HPP
+/**
+  * @file spa_mpi.hpp
+  * @brief Distribution of the realizations of ensembles and sweeps across MPI ranks (spa_networks_mpi target).
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <stddef.h> // size_t
+// STL
+#include <vector>     // tasks
+#include <functional> // realize_t, completion_t
+// Project files
+#include "sweep.hpp" // realization_batch_t
+// Typdef and helpers
+#include "types.hpp" // spa_parameters_t, network_summary_t
+
+/** @class mpi_session_t
+  * @brief Initializes MPI on construction and finalizes it on destruction (scope of main).
+  *        Aborts every rank if the library does not support MPI_THREAD_FUNNELED, since
+  *        the realizations use threads besides the one that calls MPI.
+  */
+class mpi_session_t {
+public:
+  mpi_session_t(int & argc, const char ** & argv);
+  ~mpi_session_t();
+  /** Rank of the process in MPI_COMM_WORLD. */
+  int rank() const;
+  /** Number of processes in MPI_COMM_WORLD. */
+  int size() const;
+
+private:
+  mpi_session_t(const mpi_session_t &) = delete;
+  mpi_session_t & operator = (const mpi_session_t &) = delete;
+
+  int rank_;
+  int size_;
+};
+
+typedef std::function<network_summary_t(const spa_parameters_t &)> realize_t;
+typedef std::function<void(size_t, const network_summary_t &)> completion_t;
+
+/** @name realize_distributed
+  * Dynamic distribution of realizations: the first rank deals the tasks, in
+  * order, to every rank (itself included) as soon as they are idle, and receives
+  * the statistics of the completed realizations. The first rank runs its own
+  * realizations on another thread, and polls the other ranks meanwhile. Every
+  * rank must pass the same batch (see plan_batch(2)), such that only task
+  * indices are exchanged.
+  * @param[in] <session> MPI session (at least 2 ranks).
+  * @param[in] <batch> Planned realizations.
+  * @param[in] <tasks> Indices of the realizations to run, in order (first rank only).
+  * @param[in] <threads> Number of threads of the parallel steps of each realization (0: one per core).
+  * @param[in] <realize> Runs a realization and returns its statistics.
+  * @param[in] <on_completion> Called with the index and the statistics of each completed realization (first rank only).
+  * @return Number of realizations that failed (first rank), 0 (other ranks).
+  */
+size_t realize_distributed(const mpi_session_t & session, const realization_batch_t & batch, const std::vector<size_t> & tasks, unsigned int threads, const realize_t & realize, const completion_t & on_completion);
+
+#endif //SPA_MPI_HPP
@@ -1,15 +1,22 @@
 #include "spa_network.hpp"
 
+// STL
+#include <algorithm> // std::sort, std::stable_sort (deferred mode)
+#include <atomic>    // std::atomic (deferred mode)
+#include <thread>    // std::thread (deferred mode)
+#include <utility>   // std::move
+
 // ============================================================================================
 // PUBLIC =====================================================================================
 // ============================================================================================
 
 //CTOR
-spa_network_t::spa_network_t(size_t N, size_t s, bool handle_links)  : modular_structure_t(N,N), rand_real_(0,1) {
+spa_network_t::spa_network_t(size_t N, size_t s, bool handle_links)  : modular_structure_t(N,N), subgraphs_(arena()) {
   // initialize parameters
   N_ = N;
   s_ = s;
   handle_links_ = handle_links;
+  defer_links_ = false;
   // initialize containers
   subgraphs_.clear();
   if (handle_links_) {
@@ -23,7 +30,10 @@ size_t spa_network_t::basic_size() const { return s_; }
 void spa_network_t::expand_target_size(size_t N) { if (N>N_) {N_=N;} return; }
 
 //ACCESSORS
-subgraph_t spa_network_t::get_subgraph(id_t cluster) const {return subgraphs_[cluster];}
+const subgraph_t & spa_network_t::get_subgraph(id_t cluster) const {
+  assert(handle_links_ && cluster < subgraphs_.size());
+  return subgraphs_[cluster];
+}
 bool spa_network_t::set_handle_links_status(bool status) {
   if (get_incidence_sum()>0) return false;
   else {
@@ -31,6 +41,13 @@ bool spa_network_t::set_handle_links_status(bool status) {
     return true;
   }
 }
+bool spa_network_t::set_deferred_links_status(bool status) {
+  if (get_incidence_sum()>0) return false;
+  else {
+    defer_links_=status;
+    return true;
+  }
+}
 
 //SPA OPERATIONS
 void spa_network_t::initialize(unsigned int n) {
@@ -38,78 +55,98 @@ void spa_network_t::initialize(unsigned int n) {
   return;
 }
 
-id_t spa_network_t::cluster_birth(bool new_individual, std::mt19937& engine) {
-   /* Prepare the new structural cluster */
-  std::multiset<id_t> tmp;   // content of the new cluster
-  // choose the existing nodes preferentially
-  while (tmp.size() < basic_size()-1) tmp.insert(preferential_pick("node",engine));
-  // and the last node according to new_individual
-  if (new_individual) tmp.insert(new_node());
-  else tmp.insert(preferential_pick("node",engine));
-
-  /* Structural cluster birth */
-  id_t new_cluster_id = new_cluster(tmp);
-
-  if (handle_links_) {
-    /* Subgraph handling ( new connected subgraph ) */
-    new_subgraph(new_cluster_id, true);
+template <typename engine_t>
+id_t spa_network_t::cluster_birth(bool new_individual, draw_buffer_t<engine_t>& draws) {
+  switch (link_mode()) {
+    case EXPLICIT_LINKS: return birth_kernel<EXPLICIT_LINKS, 0>(new_individual, draws);
+    case DEFERRED_LINKS: return birth_kernel<DEFERRED_LINKS, 0>(new_individual, draws);
+    default: return birth_kernel<LEGACY_LINKS, 0>(new_individual, draws);
   }
-
-  return new_cluster_id;
 }
-std::tuple<id_t, id_t> spa_network_t::cluster_growth(bool new_individual, std::mt19937& engine) {
-  /* Prepare the growth event (structural viewpoint) */
-  id_t cluster = preferential_pick("cluster",engine);
-  id_t node;
-  if (new_individual) node = new_node();
-  else node = preferential_pick("node",engine);
-
-  /* Perform the growth event */
-  add_node_to_cluster(node,cluster);
-  
-  if (handle_links_) {
-  // Subgraph handling (create the recruiting link)
-    id_t target_node_internal_id = uniform_pick(subgraphs_[cluster].size_in_nodes(),engine);
-    id_t node_internal_id = subgraphs_[cluster].add_node(node);
-    subgraphs_[cluster].connect(target_node_internal_id,node_internal_id);  
+template <typename engine_t>
+std::tuple<id_t, id_t> spa_network_t::cluster_growth(bool new_individual, draw_buffer_t<engine_t>& draws) {
+  switch (link_mode()) {
+    case EXPLICIT_LINKS: return growth_kernel<EXPLICIT_LINKS>(new_individual, draws);
+    case DEFERRED_LINKS: return growth_kernel<DEFERRED_LINKS>(new_individual, draws);
+    default: return growth_kernel<LEGACY_LINKS>(new_individual, draws);
   }
-  return std::make_tuple(node, cluster);
 }
-std::tuple<id_t, id_t, id_t, bool> spa_network_t::link_creation_step(std::mt19937& engine) {
-  if (handle_links_) {
-    id_t cluster = preferential_pick("cluster", engine); // Choose cluster (preferentially to its size)
-    id_t creating_node_internal_id = uniform_pick(subgraphs_[cluster].size_in_nodes(), engine); // Choose a link creating node
-    id_t target_node_internal_id;
-    std::set<id_t> targets_internal_id = subgraphs_[cluster].link_creation_targets(creating_node_internal_id);
-    
-    // we respect the effective size by allowing link creation steps to fail (target of size 0)
-    if (targets_internal_id.size()!=0) {
-      /* choose target node (uniform) */
-      target_node_internal_id = uniform_pick(targets_internal_id,engine);
-      /* connect */
-      subgraphs_[cluster].connect(creating_node_internal_id,target_node_internal_id);
-      return std::make_tuple(subgraphs_[cluster].get_global_id(creating_node_internal_id),
-                             subgraphs_[cluster].get_global_id(target_node_internal_id), 
-                             cluster, true);
-    }
-    return std::make_tuple(subgraphs_[cluster].get_global_id(creating_node_internal_id), 0, cluster, false);
-  }
-  else {
-    // nothing happens if links are not handled explicitly.
-    return std::make_tuple(0,0,0,false);
+template <typename engine_t>
+std::tuple<id_t, id_t, id_t, bool> spa_network_t::link_creation_step(draw_buffer_t<engine_t>& draws) {
+  switch (link_mode()) {
+    case EXPLICIT_LINKS: return link_kernel<EXPLICIT_LINKS>(draws);
+    case DEFERRED_LINKS: return link_kernel<DEFERRED_LINKS>(draws);
+    default: return link_kernel<LEGACY_LINKS>(draws);
   }
 }
+id_t spa_network_t::commit_birth(id_t * content, bool new_individual) {
+  assert(link_mode() != EXPLICIT_LINKS);
+  if (new_individual) content[basic_size() - 1] = new_node();
+  if (link_mode() == DEFERRED_LINKS) return finish_birth<DEFERRED_LINKS, 0>(content, basic_size());
+  return finish_birth<LEGACY_LINKS, 0>(content, basic_size());
+}
+std::tuple<id_t, id_t> spa_network_t::commit_growth(id_t node, id_t cluster, bool new_individual) {
+  assert(link_mode() != EXPLICIT_LINKS);
+  if (new_individual) node = new_node();
+  add_node_to_cluster(node, cluster);
+  if (link_mode() == DEFERRED_LINKS) record_event(cluster, node);
+  return std::make_tuple(node, cluster);
+}
+void spa_network_t::commit_link(id_t cluster) {
+  assert(link_mode() != EXPLICIT_LINKS);
+  if (link_mode() == DEFERRED_LINKS) record_event(cluster, link_event_token);
+  return;
+}
 void spa_network_t::purge(size_t min_community_size) {
   if (handle_links_) {
     for(id_t cluster = 0 ; cluster<size_in_clusters();++cluster) {
       if (cluster_size(cluster,true)<min_community_size) {
-        subgraphs_[cluster].clear();
+        subgraphs_.clear(cluster);
       }
     }
   }
   purge_modular_structure(min_community_size);
   return;
 }
+void spa_network_t::materialize_subgraphs(uint32_t seed, uint32_t realization, unsigned int threads) {
+  assert(handle_links_ && defer_links_ && subgraphs_.size() == 0);
+  // bucket the events by cluster, in chronological order (counting sort)
+  std::vector<size_t> offsets(size_in_clusters() + 1, 0);
+  for (auto it = events_.begin(); it != events_.end(); ++it) ++offsets[(*it >> 32) + 1];
+  for (id_t cluster = 0; cluster < size_in_clusters(); ++cluster) offsets[cluster + 1] += offsets[cluster];
+  std::vector<id_t> tokens(events_.size());
+  std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+  for (auto it = events_.begin(); it != events_.end(); ++it) tokens[cursors[*it >> 32]++] = (id_t) *it;
+  std::vector<uint64_t>().swap(events_);
+  std::vector<size_t>().swap(cursors);
+
+  // empty placeholders, replaced by the workers
+  subgraphs_.reserve(size_in_clusters());
+  for (id_t cluster = 0; cluster < size_in_clusters(); ++cluster) subgraphs_.emplace_back(nullptr, nullptr, false);
+
+  // longest event sequences first, such that the largest communities do not end up last in the queue
+  std::vector<id_t> queue(size_in_clusters());
+  for (id_t cluster = 0; cluster < size_in_clusters(); ++cluster) queue[cluster] = cluster;
+  std::stable_sort(queue.begin(), queue.end(), [&offsets](id_t a, id_t b) {
+    return offsets[a + 1] - offsets[a] > offsets[b + 1] - offsets[b];
+  });
+
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  if (threads > queue.size()) threads = std::max((size_t) 1, queue.size());
+  std::atomic<size_t> next(0);
+  auto worker = [&](arena_t * arena) {
+    for (size_t position = next++; position < queue.size(); position = next++) {
+      id_t cluster = queue[position];
+      replay(cluster, tokens.data() + offsets[cluster], tokens.data() + offsets[cluster + 1], seed, realization, *arena);
+    }
+  };
+  std::vector<std::thread> pool;
+  size_t first_arena = replay_arenas_.size();
+  for (unsigned int t = 0; t < threads; ++t) replay_arenas_.emplace_back(new arena_t());
+  for (unsigned int t = 0; t < threads; ++t) pool.emplace_back(worker, replay_arenas_[first_arena + t].get());
+  for (auto it = pool.begin(); it != pool.end(); ++it) it->join();
+  return;
+}
 
 
 // ============================================================================================
@@ -125,24 +162,61 @@ id_t spa_network_t::disjoint_cluster_birth() {
   id_t new_cluster_id =  new_cluster(nodes);
 
   if (handle_links_) {
-    new_subgraph(new_cluster_id, true);
+    if (defer_links_) record_birth(new_cluster_id);
+    else new_subgraph(new_cluster_id, true);
   }
   return new_cluster_id;
 }
 
 void spa_network_t::new_subgraph(id_t cluster, bool connected) {
   assert(cluster_exists(cluster));
-  subgraphs_.push_back(subgraph_t(get_unique_content(cluster), connected));
+  // the content is sorted: the subgraph skips the duplicates without building a set.
+  subgraphs_.emplace_back(get_content(cluster).begin(), get_content(cluster).end(), connected);
   return;
 }
-
-id_t spa_network_t::uniform_pick(const std::set<id_t> & a_set, std::mt19937& engine)  {
-  // safe, since rand_real_(0,1) excludes 1.
-  id_t target_idx = (id_t) floor(rand_real_(engine)* (double) a_set.size());
-  auto it=a_set.begin();
-  std::advance(it,target_idx);
-  return *it;
+void spa_network_t::record_event(id_t cluster, id_t token) {
+  events_.push_back(((uint64_t) cluster << 32) | token);
+  return;
+}
+void spa_network_t::record_birth(id_t cluster) {
+  assert(get_content(cluster).size() == basic_size());
+  for (auto it = get_content(cluster).begin(); it != get_content(cluster).end(); ++it) record_event(cluster, *it);
+  return;
 }
-id_t spa_network_t::uniform_pick(unsigned int upper_bound, std::mt19937& engine)  {
-  return (id_t) floor(rand_real_(engine)* (double) upper_bound);
-}
\ No newline at end of file
+void spa_network_t::replay(id_t cluster, id_t * first, id_t * last, uint32_t seed, uint32_t realization, arena_t & arena) {
+  philox4x32_t stream(seed, realization, CLUSTER_PHASE, cluster);
+  draw_buffer_t<philox4x32_t> draws(stream);
+  // birth: complete subgraph over the distinct nodes of the first basic_size() events
+  id_t * births = first + std::min((size_t) (last - first), basic_size());
+  std::sort(first, births);
+  subgraph_t subgraph(first, births, true, &arena);
+  for (const id_t * event = births; event != last; ++event) {
+    if (*event == link_event_token) {
+      // link creation step (see link_creation_step)
+      id_t creating_node_internal_id = uniform_pick(subgraph.size_in_nodes(), draws);
+      if (subgraph.is_complete()) continue;
+      size_t available_targets = subgraph.size_in_nodes() - 1 - subgraph.internal_degree(creating_node_internal_id);
+      if (available_targets != 0) {
+        subgraph.connect(creating_node_internal_id, uniform_link_target(subgraph, creating_node_internal_id, available_targets, draws));
+      }
+    }
+    else {
+      // growth (see cluster_growth)
+      id_t target_node_internal_id = uniform_pick(subgraph.size_in_nodes(), draws);
+      id_t node_internal_id = subgraph.add_node(*event);
+      subgraph.connect(target_node_internal_id, node_internal_id);
+    }
+  }
+  subgraphs_.replace(cluster, std::move(subgraph));
+  return;
+}
+
+// ============================================================================================
+// EXPLICIT INSTANTIATIONS ====================================================================
+// ============================================================================================
+
+#define INSTANTIATE_SPA_NETWORK(ENGINE) \
+  template id_t spa_network_t::cluster_birth<ENGINE>(bool, draw_buffer_t<ENGINE>&); \
+  template std::tuple<id_t, id_t> spa_network_t::cluster_growth<ENGINE>(bool, draw_buffer_t<ENGINE>&); \
+  template std::tuple<id_t, id_t, id_t, bool> spa_network_t::link_creation_step<ENGINE>(draw_buffer_t<ENGINE>&);
+SPA_FOR_EACH_ENGINE(INSTANTIATE_SPA_NETWORK)
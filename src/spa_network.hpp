@@ -9,21 +9,35 @@
   * @version 0.4
   */
 
+// Configuration file
+#include "config.h"
 // C libraries
-#include <math.h>    // floor
 #include <stddef.h>  // size_t
+#include <stdint.h>  // uint32_t, uint64_t (deferred mode)
 #include <assert.h> // error checking: turn off with #define NDEBUG
 // STL
 #include <set>      // std::multiset (private data members)
 #include <vector>   // std::vector< std::multiset > (private data members)
 #include <tuple>    // return type for event 
-#include <random>   // uniform_real_distribution
+#include <memory>   // std::unique_ptr (replay arenas)
+#include <algorithm> // std::sort, std::swap (kernels)
 // Project files
 #include "modular_structure.hpp" // base-class on which spa_network_t is built
-#include "subgraph.hpp" // a private data member
+#include "subgraph.hpp" // subgraph_t
+#include "subgraph_store.hpp" // a private data member
+#include "draw_buffer.hpp" // draw_buffer_t (explicit instantiations)
 // Typdefs
 #include "types.hpp" // id_t
 
+/// Link handling modes of spa_network_t (see the SPA kernels).
+enum link_mode_t {
+  /// Links are not handled, communities are assumed fully connected (legacy SPA).
+  LEGACY_LINKS = 0,
+  /// Subgraphs grow along with the communities (SPA*).
+  EXPLICIT_LINKS = 1,
+  /// Subgraph events are recorded, and the subgraphs built afterwards (see spa_network_t::materialize_subgraphs).
+  DEFERRED_LINKS = 2
+};
 
 /** @class spa_network_t
   * @brief Network class for SPA processes
@@ -67,14 +81,25 @@ public:
   /** @name Accessors
     */
   //@{
-  /** Return a subgraph object, identified by its cluster ID. */
-  subgraph_t get_subgraph(id_t cluster) const;
+  /** Return a read-only view of a subgraph object, identified by its cluster ID. No copy is made. 
+    * @warning Subgraphs only exist if links are handled explicitly.
+    */
+  const subgraph_t & get_subgraph(id_t cluster) const;
   /** Set link handling status.
     * @warning This method will fail if the network already started to grow.
     *   It is only provided to loosen scoping constraints.
     * @return true if the status change worked, false otherwise.
     */
   bool set_handle_links_status(bool status);
+  /** Set deferred link handling status. In deferred mode, the events of each 
+    * subgraph are only recorded during the growth, and the subgraphs are built
+    * afterwards by materialize_subgraphs(3).
+    * @warning This method will fail if the network already started to grow.
+    * @return true if the status change worked, false otherwise.
+    */
+  bool set_deferred_links_status(bool status);
+  /** Current link handling mode. */
+  link_mode_t link_mode() const;
   //@}
 
   /** @name SPA Operations
@@ -92,21 +117,21 @@ public:
     * @remark Regardless of the links handling method, cluster are always born
     *   with complete connectivity.
     * @param[in] <new_individual> Determine whether the node is new or old.
-    * @param[in] <engine> Initialized pseudo-RNG engine of the std::mt19937 type.
+    * @param[in] <draws> Draw buffer of an initialized pseudo-RNG engine (see draw_buffer.hpp).
     * @return The identifier of the new cluster.
     */
-  id_t cluster_birth(bool new_individual, std::mt19937& engine);
+  template <typename engine_t> id_t cluster_birth(bool new_individual, draw_buffer_t<engine_t>& draws);
   /** A preferentially chosen cluster gains one node, chosen preferentially to
     * its number of participations (membership number). 
     * @remark If links are handled explicitly, a link is created with 
     *   uniform probability between the new node and any node in the growing 
     *   cluster.
     * @param[in] <new_individual> Determine whether the node is new or old.
-    * @param[in] <engine> Initialized pseudo-RNG engine of the std::mt19937 type.
+    * @param[in] <draws> Draw buffer of an initialized pseudo-RNG engine (see draw_buffer.hpp).
     * @return A std::tuple<id_t,id_t> containing the identifiers of the node (<0>) 
     *   and cluster (<1>) involved in the growth event. 
     */
-  std::tuple<id_t, id_t> cluster_growth(bool new_individual, std::mt19937& engine);
+  template <typename engine_t> std::tuple<id_t, id_t> cluster_growth(bool new_individual, draw_buffer_t<engine_t>& draws);
   /** Creates a link within a uniformly chosen cluster of a preferentially 
     * chosen node. The target node is chosen uniformly from the set of
     * available stubs.
@@ -114,13 +139,16 @@ public:
     *   not turned on.
     * @remark This method is allowed to fail if a node of maximal degree is 
     *   selected. This ensures that temporal mapping are respected (see articles).
-    * @param[in] <engine> Initialized pseudo-RNG engine of the std::mt19937 type.
+    *   Failures in complete subgraphs are detected in O(1).
+    * @param[in] <draws> Draw buffer of an initialized pseudo-RNG engine (see draw_buffer.hpp).
     * @return A std::tuple<id_t,id_t,id_t,bool>, where
     *   <0> and <1> contain the identifiers of the source and target nodes,
     *   <2> contains the identifier of the cluster in which the link creation event occurred,
     *   <3> contains a boolean that indicates whether the event was successful or not. 
+    * @remark In deferred mode, only the cluster is picked: the event is recorded and 
+    *   reported as unsuccessful (its outcome is not known until the replay).
     */
-  std::tuple<id_t, id_t, id_t, bool> link_creation_step(std::mt19937& engine);
+  template <typename engine_t> std::tuple<id_t, id_t, id_t, bool> link_creation_step(draw_buffer_t<engine_t>& draws);
   /** Delete every cluster and subgraph of size bellow a certain threshold.
     * @param[in] <min_cluster_size> Cluster size threshold.
     * @warning This member function effectively reduces some elements 
@@ -128,6 +156,54 @@ public:
     * Output and data analysis must be done accordingly.
     */
   void purge(size_t min_cluster_size);
+  /** Build the subgraphs from the events recorded in deferred mode, in parallel.
+    * Each subgraph replays its own events (birth, joins and link creation steps, 
+    * in chronological order) with its own stream philox4x32_t(seed, realization, CLUSTER_PHASE, cluster),
+    * such that the result does not depend on the number of threads.
+    * @remark The structural process does not depend on the links, hence the networks
+    *   have the same distribution as when the subgraphs grow along with the communities.
+    * @param[in] <seed> Seed of the streams.
+    * @param[in] <realization> Index of the realization (key of the streams, with the seed).
+    * @param[in] <threads> Number of threads (0: one per core).
+    */
+  void materialize_subgraphs(uint32_t seed, uint32_t realization, unsigned int threads);
+  //@}
+
+  /** @name SPA kernels
+    * Same operations as cluster_birth(2), cluster_growth(2) and link_creation_step(1),
+    * specialized at compilation time on the link handling mode (@p links, which must
+    * be link_mode()) and on the basic size (@p s, which must be basic_size(), or 0 for 
+    * any size). Drivers select the kernels once per simulation: the events do not test 
+    * the mode, and births of small communities do not allocate.
+    */
+  //@{
+  template <link_mode_t links, unsigned int s, typename engine_t> id_t birth_kernel(bool new_individual, draw_buffer_t<engine_t>& draws);
+  template <link_mode_t links, typename engine_t> std::tuple<id_t, id_t> growth_kernel(bool new_individual, draw_buffer_t<engine_t>& draws);
+  template <link_mode_t links, typename engine_t> std::tuple<id_t, id_t, id_t, bool> link_kernel(draw_buffer_t<engine_t>& draws);
+  //@}
+
+  /** @name Relaxed consistency
+    * Events in two phases, for the relaxed growth mode (see spa_relaxed): the preferential
+    * picks of many events are first drawn against the same state of the network, possibly
+    * concurrently, and the events are then committed one by one, in order.
+    * @warning Links must not be handled explicitly (the subgraph events are recorded instead).
+    */
+  //@{
+  /** Preferential picks that do not modify the network: concurrent calls are safe as long as no event is committed. */
+  template <typename engine_t> id_t snapshot_pick_node(draw_buffer_t<engine_t>& draws) const;
+  template <typename engine_t> id_t snapshot_pick_cluster(draw_buffer_t<engine_t>& draws) const;
+  /** Cluster birth with the nodes @p content[0], ..., @p content[basic_size()-1], where the 
+    * last one is ignored and replaced by a new node if @p new_individual. 
+    * @p content is sorted in place.
+    * @return The identifier of the new cluster.
+    */
+  id_t commit_birth(id_t * content, bool new_individual);
+  /** Cluster growth of @p cluster, with @p node, or a new node if @p new_individual.
+    * @return Same as cluster_growth(2).
+    */
+  std::tuple<id_t, id_t> commit_growth(id_t node, id_t cluster, bool new_individual);
+  /** Link creation step in @p cluster. */
+  void commit_link(id_t cluster);
   //@}
 
 private:
@@ -137,8 +213,23 @@ private:
   //@{
   id_t disjoint_cluster_birth();
   void new_subgraph(id_t cluster, bool connected);
-  id_t uniform_pick(const std::set<id_t> & a_set, std::mt19937& engine);
-  id_t uniform_pick(unsigned int upper_bound, std::mt19937& engine);
+  /** Record an event of the subgraph of @p cluster (deferred mode). */
+  void record_event(id_t cluster, id_t token);
+  /** Record the content of a new cluster, i.e. its first basic_size() events (deferred mode). */
+  void record_birth(id_t cluster);
+  /** Build the subgraph of @p cluster from its events [first, last[, with memory from @p arena. */
+  void replay(id_t cluster, id_t * first, id_t * last, uint32_t seed, uint32_t realization, arena_t & arena);
+  template <typename engine_t> id_t uniform_pick(const std::vector<id_t> & a_vector, draw_buffer_t<engine_t>& draws);
+  template <typename engine_t> id_t uniform_pick(unsigned int upper_bound, draw_buffer_t<engine_t>& draws);
+  /** Pick a node uniformly among the nodes of @p subgraph that are not connected to @p internal_node_id. 
+    * @remark Uses rejection sampling if the LINK_REJECTION_SAMPLING macro is set to 1 and 
+    *   enough targets are available, the (allocation-free) enumeration otherwise.
+    */
+  template <typename engine_t> id_t uniform_link_target(const subgraph_t & subgraph, id_t internal_node_id, size_t available_targets, draw_buffer_t<engine_t>& draws);
+  /** Sort the content of a new cluster of size @p size (sorting networks for s <= 3). */
+  template <unsigned int s> static void sort_content(id_t * content, size_t size);
+  /** Birth of a cluster with the nodes [content, content + size[ (sorted in place). */
+  template <link_mode_t links, unsigned int s> id_t finish_birth(id_t * content, size_t size);
   //@}
 
   /** @name Private data members */
@@ -149,16 +240,156 @@ private:
   size_t N_;
   /// Determine whether links are handled using SPA*, or legacy versions (full connectivity).
   bool handle_links_;
+  /// Determine whether the subgraphs are built after the growth (see materialize_subgraphs).
+  bool defer_links_;
   //@}
 
-  /// Internal distribution. Generator must be passed as a service
-  std::uniform_real_distribution<double> rand_real_;
+  /// Event token of a link creation step (other tokens are the joining nodes).
+  static const id_t link_event_token = (id_t) -1;
 
   /** @name State container */
   //@{
+  /// Events of the subgraphs in deferred mode, (cluster << 32) | token, in chronological order.
+  std::vector<uint64_t> events_;
+  /// Arenas of the subgraphs built by materialize_subgraphs (one per thread).
+  std::vector< std::unique_ptr<arena_t> > replay_arenas_;
   /// Explicit subgraph connectivity container
-  std::vector< subgraph_t > subgraphs_;
+  subgraph_store_t subgraphs_;
+  /// Content of the new clusters of the generic birth kernel (reused, s > 3).
+  std::vector<id_t> birth_content_;
   //@}
 };
 
+// Kernels and picks are defined in the header, such that the drivers get the specializations they select.
+inline link_mode_t spa_network_t::link_mode() const {
+  return !handle_links_ ? LEGACY_LINKS : (defer_links_ ? DEFERRED_LINKS : EXPLICIT_LINKS);
+}
+
+template <link_mode_t links, unsigned int s, typename engine_t>
+id_t spa_network_t::birth_kernel(bool new_individual, draw_buffer_t<engine_t>& draws) {
+  assert(links == link_mode() && (s == 0 || s == basic_size()));
+  const size_t size = s == 0 ? basic_size() : s;
+  id_t fixed_content[s == 0 ? 1 : s];
+  id_t * content = fixed_content;
+  if (s == 0) {
+    birth_content_.resize(size);
+    content = birth_content_.data();
+  }
+  /* Prepare the new structural cluster */
+  // choose the existing nodes preferentially
+  for (size_t i = 0; i + 1 < size; ++i) content[i] = preferential_pick_node(draws);
+  // and the last node according to new_individual
+  content[size - 1] = new_individual ? new_node() : preferential_pick_node(draws);
+  return finish_birth<links, s>(content, size);
+}
+template <link_mode_t links, unsigned int s>
+id_t spa_network_t::finish_birth(id_t * content, size_t size) {
+  sort_content<s>(content, size);
+
+  /* Structural cluster birth */
+  id_t new_cluster_id = new_cluster(content, content + size);
+
+  /* Subgraph handling ( new connected subgraph ) */
+  if (links == EXPLICIT_LINKS) new_subgraph(new_cluster_id, true);
+  else if (links == DEFERRED_LINKS) record_birth(new_cluster_id);
+  return new_cluster_id;
+}
+template <link_mode_t links, typename engine_t>
+std::tuple<id_t, id_t> spa_network_t::growth_kernel(bool new_individual, draw_buffer_t<engine_t>& draws) {
+  assert(links == link_mode());
+  /* Prepare the growth event (structural viewpoint) */
+  id_t cluster = preferential_pick_cluster(draws);
+  id_t node = new_individual ? new_node() : preferential_pick_node(draws);
+
+  /* Perform the growth event */
+  add_node_to_cluster(node,cluster);
+  
+  if (links == EXPLICIT_LINKS) {
+    // Subgraph handling (create the recruiting link)
+    id_t target_node_internal_id = uniform_pick(subgraphs_.size_in_nodes(cluster),draws);
+    id_t node_internal_id = subgraphs_.add_node(cluster,node);
+    subgraphs_.connect(cluster,target_node_internal_id,node_internal_id);  
+  }
+  else if (links == DEFERRED_LINKS) record_event(cluster, node);
+  return std::make_tuple(node, cluster);
+}
+template <link_mode_t links, typename engine_t>
+std::tuple<id_t, id_t, id_t, bool> spa_network_t::link_kernel(draw_buffer_t<engine_t>& draws) {
+  assert(links == link_mode());
+  // nothing happens if links are not handled explicitly.
+  if (links == LEGACY_LINKS) return std::make_tuple(0,0,0,false);
+  id_t cluster = preferential_pick_cluster(draws); // Choose cluster (preferentially to its size)
+  if (links == DEFERRED_LINKS) {
+    // the rest of the step only depends on the subgraph
+    record_event(cluster, link_event_token);
+    return std::make_tuple(0, 0, cluster, false);
+  }
+  id_t creating_node_internal_id = uniform_pick(subgraphs_.size_in_nodes(cluster), draws); // Choose a link creating node
+  const subgraph_t & subgraph = subgraphs_[cluster];
+  
+  // we respect the effective size by allowing link creation steps to fail (no target available)
+  if (subgraphs_.is_complete(cluster)) return std::make_tuple(subgraph.get_global_id(creating_node_internal_id), 0, cluster, false);
+  size_t available_targets = subgraph.size_in_nodes() - 1 - subgraph.internal_degree(creating_node_internal_id);
+  if (available_targets != 0) {
+    /* choose target node (uniform) */
+    id_t target_node_internal_id = uniform_link_target(subgraph, creating_node_internal_id, available_targets, draws);
+    /* connect */
+    subgraphs_.connect(cluster,creating_node_internal_id,target_node_internal_id);
+    return std::make_tuple(subgraph.get_global_id(creating_node_internal_id),
+                           subgraph.get_global_id(target_node_internal_id), 
+                           cluster, true);
+  }
+  return std::make_tuple(subgraph.get_global_id(creating_node_internal_id), 0, cluster, false);
+}
+
+template <typename engine_t>
+id_t spa_network_t::snapshot_pick_node(draw_buffer_t<engine_t>& draws) const {
+  return preferential_pick_node(draws);
+}
+template <typename engine_t>
+id_t spa_network_t::snapshot_pick_cluster(draw_buffer_t<engine_t>& draws) const {
+  return preferential_pick_cluster(draws);
+}
+
+template <typename engine_t>
+id_t spa_network_t::uniform_pick(const std::vector<id_t> & a_vector, draw_buffer_t<engine_t>& draws)  {
+  id_t target_idx = (id_t) draws.bounded(a_vector.size());
+  return a_vector[target_idx];
+}
+template <typename engine_t>
+id_t spa_network_t::uniform_pick(unsigned int upper_bound, draw_buffer_t<engine_t>& draws)  {
+  return (id_t) draws.bounded(upper_bound);
+}
+template <typename engine_t>
+id_t spa_network_t::uniform_link_target(const subgraph_t & subgraph, id_t internal_node_id, size_t available_targets, draw_buffer_t<engine_t>& draws) {
+  #if LINK_REJECTION_SAMPLING == 1
+    // Draw uniform nodes until a non-neighbor is found. Expected number of draws: n / available_targets,
+    // so we fall back to the enumeration once less than half of the nodes are available.
+    if (2 * available_targets >= subgraph.size_in_nodes()) {
+      id_t target;
+      do {
+        target = uniform_pick(subgraph.size_in_nodes(), draws);
+      } while (target == internal_node_id || subgraph.are_neighbors(internal_node_id, target));
+      return target;
+    }
+  #endif
+  // Enumeration: same pick as uniform_pick(subgraph.link_creation_targets(internal_node_id), draws).
+  return subgraph.link_creation_target(internal_node_id, uniform_pick(available_targets, draws));
+}
+
+template <unsigned int s>
+void spa_network_t::sort_content(id_t * content, size_t size) {std::sort(content, content + size);}
+template <>
+inline void spa_network_t::sort_content<1>(id_t *, size_t) { }
+template <>
+inline void spa_network_t::sort_content<2>(id_t * content, size_t) {
+  if (content[1] < content[0]) std::swap(content[0], content[1]);
+}
+template <>
+inline void spa_network_t::sort_content<3>(id_t * content, size_t) {
+  if (content[1] < content[0]) std::swap(content[0], content[1]);
+  if (content[2] < content[1]) std::swap(content[1], content[2]);
+  if (content[1] < content[0]) std::swap(content[0], content[1]);
+}
+
 #endif //SPA_NETWORK_HPP
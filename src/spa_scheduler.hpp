@@ -0,0 +1,124 @@
+#ifndef SPA_SCHEDULER_HPP
+#define SPA_SCHEDULER_HPP
+/**
+  * @file spa_scheduler.hpp
+  * @brief Batched schedule of the events of the SPA process.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+#include <math.h>   // log, floor
+// STL
+#include <vector>   // blocks of events
+#include <limits>   // std::numeric_limits
+// Project files
+#include "draw_buffer.hpp" // draw_buffer_t, probability_t
+
+/*  The decisions of the SPA process do not depend on the state of the network:
+ *  at each step, a community is born with probability p (grows otherwise), the
+ *  node is new with probability q, and a number of link creation steps follow.
+ *  The scheduler draws these decisions for a whole block of structural events
+ *  at once, in a tight loop, and the drivers then apply the block to the network:
+ *
+ *    - birth / growth and new / old node are fused into a single draw against
+ *      the cumulative thresholds pq, p and p + (1-p)q,
+ *    - in the slow regime (r(1-p) < 1), the structural events that are followed
+ *      by a link creation step are found by geometric skips, instead of a die
+ *      per event,
+ *    - in the fast regime (r(1-p) >= 1), the number of additional link creation
+ *      steps before a structural event is geometric (success probability 1/(r(1-p))).
+ *
+ *  The law of the process is unchanged. Block boundaries are batch boundaries:
+ *  the network is in a consistent state between two blocks.
+ */
+
+/** @class spa_event_t
+  * @brief Decisions of one structural event, and of the link creation steps around it.
+  */
+struct spa_event_t {
+  /// Number of link creation steps before the structural event.
+  uint64_t links_before;
+  /// Cluster birth (true) or growth (false).
+  bool birth;
+  /// New node (true) or preferentially chosen one (false).
+  bool new_individual;
+  /// A link creation step follows the structural event.
+  bool link_after;
+};
+
+/** @class spa_scheduler_t
+  * @brief Draws the decisions of the SPA process by blocks of @p block_size structural events.
+  */
+template <typename engine_t>
+class spa_scheduler_t {
+public:
+  /// Number of structural events per block.
+  static const size_t block_size = 1024;
+
+  /** @param[in] <p> Community birth probability.
+    * @param[in] <q> Probability that a node is a new one.
+    * @param[in] <link_rate> Link creation steps per structural event, r(1-p) (0: no links).
+    * @param[in,out] <draws> Draw buffer, must outlive the scheduler.
+    */
+  spa_scheduler_t(double p, double q, double link_rate, draw_buffer_t<engine_t> & draws) :
+    draws_(draws),
+    birth_new_(p * q), birth_(p), growth_new_(p + (1 - p) * q),
+    fast_(link_rate >= 1), skip_(0) {
+    if (fast_) log_complement_ = log(1 - 1 / link_rate);
+    else if (link_rate > 0) log_complement_ = log(1 - link_rate);
+    else log_complement_ = 0;
+    if (!fast_) skip_ = geometric();
+    block_.resize(block_size);
+  }
+
+  /** Draw the decisions of the next block.
+    * @return The block, valid until the next call.
+    */
+  const std::vector<spa_event_t> & next_block() {
+    for (size_t i = 0; i < block_size; ++i) {
+      spa_event_t & event = block_[i];
+      const uint64_t u = draws_.unit();
+      event.birth = u < birth_.fixed;
+      event.new_individual = u < birth_new_.fixed || (u >= birth_.fixed && u < growth_new_.fixed);
+      if (fast_) {
+        event.links_before = geometric();
+        event.link_after = true;
+      }
+      else {
+        event.links_before = 0;
+        event.link_after = skip_ == 0;
+        skip_ = skip_ == 0 ? geometric() : skip_ - 1;
+      }
+    }
+    return block_;
+  }
+
+private:
+  /** Number of failures before the first success, where failures have probability exp(log_complement_). */
+  uint64_t geometric() {
+    if (log_complement_ == 0) return fast_ ? 0 : std::numeric_limits<uint64_t>::max();
+    // inversion, with a uniform in ]0,1]
+    const double u = (double) (draws_.unit() + 1) * (1.0 / 9007199254740992.0);
+    const double skip = floor(log(u) / log_complement_);
+    return skip < 1.8e19 ? (uint64_t) skip : std::numeric_limits<uint64_t>::max();
+  }
+
+  draw_buffer_t<engine_t> & draws_;
+  /// Cumulative thresholds of the fused decision: birth of a new node, birth, growth of a new node.
+  probability_t birth_new_, birth_, growth_new_;
+  /// Regime: link creation steps on a faster time-scale than structural events.
+  bool fast_;
+  /// Logarithm of the failure probability of the geometric draws (0: always succeed, or never in the slow regime).
+  double log_complement_;
+  /// Slow regime: number of structural events before the next one that is followed by a link creation step.
+  uint64_t skip_;
+  std::vector<spa_event_t> block_;
+};
+
+#endif //SPA_SCHEDULER_HPP
@@ -1,149 +1,220 @@
 #include "subgraph.hpp"
 
+#if defined(__BMI2__)
+  #include <immintrin.h> // _pdep_u64
+#endif
+
+// Bitset helpers (dense subgraphs) ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace {
+  /// Word with bit @p idx set.
+  inline uint64_t bit(id_t idx) {return (uint64_t) 1 << idx;}
+  /// Word with the @p n lowest bits set (n <= 64).
+  inline uint64_t lowest_bits(size_t n) {return n >= 64 ? ~(uint64_t) 0 : bit((id_t) n) - 1;}
+  inline unsigned int popcount(uint64_t word) {return __builtin_popcountll(word);}
+  /// Position of the (rank+1)-th set bit of @p word, which must contain more than @p rank set bits.
+  inline id_t select_bit(uint64_t word, unsigned int rank) {
+    #if defined(__BMI2__)
+      return __builtin_ctzll(_pdep_u64(bit(rank), word));
+    #else
+      // Binary search on popcounts down to a byte, then clear the lowest bits of that byte.
+      id_t position = 0;
+      for (unsigned int width = 32; width >= 8; width /= 2) {
+        unsigned int count = popcount(word & lowest_bits(width));
+        if (rank >= count) {
+          rank -= count;
+          word >>= width;
+          position += width;
+        }
+      }
+      for (; rank > 0; --rank) word &= word - 1;
+      return position + __builtin_ctzll(word);
+    #endif
+  }
+}
+
+// Adjacency list helpers (sparse subgraphs, narrow or wide identifiers) ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace {
+  /// Append the nodes of [0, n) that are neither in @p neighbors nor @p node to @p targets.
+  template <typename list_t>
+  void append_non_neighbors(const list_t & neighbors, id_t node, size_t n, std::vector<id_t> & targets) {
+    // walk the sorted neighborhood and keep the gaps, minus the node itself.
+    auto it = neighbors.begin();
+    for (id_t candidate = 0; candidate < n; ++candidate) {
+      if (it != neighbors.end() && *it == candidate) ++it;
+      else if (candidate != node) targets.push_back(candidate);
+    }
+  }
+  /// The @p rank -th node that is neither in @p neighbors nor @p node.
+  template <typename list_t>
+  id_t nth_non_neighbor(const list_t & neighbors, id_t node, size_t rank) {
+    // Skip every excluded node (neighbors and the node itself) that precedes the candidate.
+    // Both sequences are sorted, so each excluded node is visited once.
+    size_t target = rank;
+    bool self_skipped = false;
+    auto it = neighbors.begin();
+    while (true) {
+      if (!self_skipped && node <= target && (it == neighbors.end() || node < *it)) {
+        ++target;
+        self_skipped = true;
+      }
+      else if (it != neighbors.end() && *it <= target) {
+        ++target;
+        ++it;
+      }
+      else break;
+    }
+    return (id_t) target;
+  }
+  /// Insert the link (node1, node2) in the sorted lists. @return False if the link already exists.
+  template <typename list_t>
+  bool insert_link(list_t & neighbors_1, list_t & neighbors_2, id_t node1, id_t node2) {
+    typedef typename list_t::value_type local_id_t;
+    auto position_1 = std::lower_bound(neighbors_1.begin(),neighbors_1.end(),node2);
+    if (position_1 != neighbors_1.end() && *position_1 == node2) return false;
+    neighbors_1.insert(position_1,(local_id_t) node2);
+    neighbors_2.insert(std::lower_bound(neighbors_2.begin(),neighbors_2.end(),node1),(local_id_t) node1);
+    return true;
+  }
+}
+
 // ============================================================================================
 // PUBLIC =====================================================================================
 // ============================================================================================
 
-subgraph_t::subgraph_t() 
-#if MEMORY_OPTIMIZED == 0
-  : internal_degrees_(0,0) 
-#endif
-{ }
+subgraph_t::subgraph_t(arena_t * arena) : 
+  rows_(arena_allocator_t<uint64_t>(arena)),
+  narrow_adjacency_(arena_allocator_t< arena_vector_t<narrow_id_t> >(arena)),
+  wide_adjacency_(arena_allocator_t< arena_vector_t<id_t> >(arena)),
+  links_count_(0),
+  global_ids_(arena_allocator_t<id_t>(arena)) { }
 
 // Ctor
-subgraph_t::subgraph_t(std::set< id_t > nodes, bool connected) 
-#if MEMORY_OPTIMIZED == 0
-  : internal_degrees_(0,0) 
-#endif
-{
+subgraph_t::subgraph_t(std::set< id_t > nodes, bool connected, arena_t * arena) : subgraph_t(arena) {
   // map ids
+  global_ids_.reserve(nodes.size());
+  if (nodes.size() <= dense_capacity) rows_.reserve(nodes.size());
   for (auto it = nodes.begin(); it!=nodes.end();++it) {
     add_node(*it);
   }
   if (connected) fully_connect();
 }
+subgraph_t::subgraph_t(const id_t * first, const id_t * last, bool connected, arena_t * arena) : subgraph_t(arena) {
+  for (const id_t * it = first; it != last; ++it) {
+    if (it == first || *it != *(it - 1)) add_node(*it);
+  }
+  if (connected) fully_connect();
+}
 
 // Capacity
-size_t subgraph_t::size_in_links() const {return links_.size();}
-size_t subgraph_t::size_in_nodes() const {return id_map_.size();}
+size_t subgraph_t::size_in_links() const {return links_count_;}
+size_t subgraph_t::size_in_nodes() const {return global_ids_.size();}
+size_t subgraph_t::missing_links() const {
+  return size_in_nodes() * (size_in_nodes() - 1) / 2 - links_count_;
+}
+bool subgraph_t::is_complete() const {return missing_links() == 0;}
 
 // Accessors
 std::vector< unsigned int > subgraph_t::get_internal_degrees() const {
-  #if MEMORY_OPTIMIZED == 0
-    return internal_degrees_;
-  #else 
-    std::vector< unsigned int > degrees(size_in_nodes(),0);
-    for (auto it = links_.begin(); it!=links_.end();++it) {
-      ++degrees[it->first];
-      ++degrees[it->second];
-    }
-    return degrees;
-  #endif
+  std::vector< unsigned int > degrees(size_in_nodes(),0);
+  for (id_t node = 0; node < size_in_nodes(); ++node)
+    degrees[node] = internal_degree(node);
+  return degrees;
+}
+size_t subgraph_t::internal_degree(id_t internal_node_id) const {
+  assert(node_exists(internal_node_id));
+  if (is_dense()) return popcount(rows_[internal_node_id]);
+  if (is_narrow()) return narrow_adjacency_[internal_node_id].size();
+  return wide_adjacency_[internal_node_id].size();
+}
+std::set< edge_t > subgraph_t::get_local_links() const {
+  std::set< edge_t > tmp;
+  for_each_link([&tmp](id_t node1, id_t node2) {tmp.insert(tmp.end(),std::make_pair(node1,node2));});
+  return tmp;
 }
-std::set< edge_t > subgraph_t::get_local_links() const {return links_;}
 std::multiset< edge_t > subgraph_t::get_global_links() const {
   std::multiset< edge_t > tmp;
-  for (auto it = links_.begin();it!=links_.end();++it) {
-    id_t node1 = get_global_id(it->first);
-    id_t node2 = get_global_id(it->second);
+  for_each_link([&](id_t internal_node1, id_t internal_node2) {
+    id_t node1 = get_global_id(internal_node1);
+    id_t node2 = get_global_id(internal_node2);
     node1 <= node2 ? tmp.insert(std::make_pair(node1,node2)) : tmp.insert(std::make_pair(node2,node1));
-  }
+  });
   return tmp;
 }
 id_t subgraph_t::get_global_id(id_t internal_node_id)  const {
   assert(node_exists(internal_node_id));
-  return id_map_.at(internal_node_id); // throw exception rather than insert a new node;­
+  return global_ids_[internal_node_id];
 }
 std::set<id_t> subgraph_t::get_global_ids() const {
-  std::set<id_t> global_nodes;
-  #if MEMORY_OPTIMIZED == 0
-  for (auto it = nodes_.begin(); it!=nodes_.end(); ++it)
-    global_nodes.insert(get_global_id(*it));
-  #else
-  for (auto it = id_map_.begin();it!=id_map_.end();++it)
-    global_nodes.insert(get_global_id(it->second)); //marginally slower than the !MEMORY_OPTIMIZED method.
-  #endif
-  return global_nodes;
+  return std::set<id_t>(global_ids_.begin(),global_ids_.end());
 }
 void subgraph_t::clear() {
-  links_.clear();
-  id_map_.clear();
-  #if MEMORY_OPTIMIZED == 0
-    internal_degrees_.clear();
-    nodes_.clear();
-  #endif
+  rows_.clear();
+  narrow_adjacency_.clear();
+  wide_adjacency_.clear();
+  links_count_ = 0;
+  global_ids_.clear();
 }
 
 // Structural utilities
-std::set<id_t> subgraph_t::link_creation_targets(id_t internal_node_id) {
-  // if (links_.size() > 0) {
-  #if MEMORY_OPTIMIZED == 0
-    if (internal_degrees_[internal_node_id]==size_in_nodes()-1) return std::set<id_t>(); // early exit
-  #endif
-
-  std::set<id_t> known_nodes;
-  known_nodes.insert(internal_node_id);
-  for (id_t node = 0; node < internal_node_id; ++node) 
-    if (links_.find(std::make_pair(node,internal_node_id))!=links_.end())
-      known_nodes.insert(node);
-
-  for (id_t node = internal_node_id+1; node < size_in_nodes(); ++node) 
-    if (links_.find(std::make_pair(internal_node_id,node))!=links_.end())
-      known_nodes.insert(node);
-
-  #ifdef MEMORY_OPTIMIZED
-    std::set<id_t> nodes_;
-    for (id_t node = 0; node < size_in_nodes(); ++node)
-      nodes_.insert(node);
-  #endif
-
-  std::set<id_t> targets;
-  std::set_difference(nodes_.begin(),nodes_.end(),known_nodes.begin(),known_nodes.end(),std::inserter(targets,targets.end()));
+std::vector<id_t> subgraph_t::link_creation_targets(id_t internal_node_id) const {
+  assert(node_exists(internal_node_id));
+  std::vector<id_t> targets;
+  size_t degree = internal_degree(internal_node_id);
+  if (degree == size_in_nodes()-1) return targets; // early exit
+  targets.reserve(size_in_nodes() - 1 - degree);
+  if (is_dense()) {
+    uint64_t word = ~(rows_[internal_node_id] | bit(internal_node_id)) & lowest_bits(size_in_nodes());
+    for (; word != 0; word &= word - 1) targets.push_back(__builtin_ctzll(word));
+  }
+  else if (is_narrow()) append_non_neighbors(narrow_adjacency_[internal_node_id], internal_node_id, size_in_nodes(), targets);
+  else append_non_neighbors(wide_adjacency_[internal_node_id], internal_node_id, size_in_nodes(), targets);
   return targets;
-  //   std::set<id_t> forbidden_nodes;
-  //   forbidden_nodes.insert(internal_node_id);
-  //   forbidden_nodes.insert(next_internal_id_);
-  //   for (auto it = links_.begin(); it!=links_.end();++it) {
-  //     if (it->first == internal_node_id) forbidden_nodes.insert(it->second);
-  //     if (it->second == internal_node_id) forbidden_nodes.insert(it->first);
-  //   }
-  //   // build targets
-  //   std::set<id_t> targets;
-  //   auto it = forbidden_nodes.begin();
-  //   for (id_t potential_target = 0; potential_target < next_internal_id_; ++potential_target) {
-  //     if (potential_target < *it) targets.insert(potential_target);
-  //     else ++it;
-  //   }
-  //   return targets;
-  // }
-  // else return std::set<id_t>();
+}
+id_t subgraph_t::link_creation_target(id_t internal_node_id, size_t rank) const {
+  assert(node_exists(internal_node_id));
+  assert(rank < size_in_nodes() - 1 - internal_degree(internal_node_id));
+  if (is_dense()) {
+    // select the rank-th zero bit of the row, the node itself excluded.
+    uint64_t word = ~(rows_[internal_node_id] | bit(internal_node_id)) & lowest_bits(size_in_nodes());
+    return select_bit(word, (unsigned int) rank);
+  }
+  if (is_narrow()) return nth_non_neighbor(narrow_adjacency_[internal_node_id], internal_node_id, rank);
+  return nth_non_neighbor(wide_adjacency_[internal_node_id], internal_node_id, rank);
 }
 
 id_t subgraph_t::add_node(id_t global_node_id) {
   // off by one: the new id is given by the current size in nodes
-  id_map_[size_in_nodes()] = global_node_id;
-  #if MEMORY_OPTIMIZED == 0
-    internal_degrees_.push_back(0);
-    nodes_.insert(size_in_nodes()-1);
-  #endif
+  global_ids_.push_back(global_node_id);
+  if (size_in_nodes() <= dense_capacity) rows_.push_back(0);
+  else if (size_in_nodes() == dense_capacity + 1) promote();
+  else if (size_in_nodes() <= narrow_capacity) narrow_adjacency_.emplace_back(narrow_adjacency_.get_allocator());
+  else if (size_in_nodes() == narrow_capacity + 1) widen();
+  else wide_adjacency_.emplace_back(wide_adjacency_.get_allocator());
   return size_in_nodes()-1;
 }
 void subgraph_t::connect(id_t internal_node_id_1, id_t internal_node_id_2) {
   assert(node_exists(internal_node_id_1) && node_exists(internal_node_id_2));
   assert(internal_node_id_1 != internal_node_id_2);
-  if (internal_node_id_1 < internal_node_id_2) {
-    links_.insert(std::make_pair(internal_node_id_1,internal_node_id_2));
+  if (is_dense()) {
+    if (rows_[internal_node_id_1] & bit(internal_node_id_2)) return; // already connected
+    rows_[internal_node_id_1] |= bit(internal_node_id_2);
+    rows_[internal_node_id_2] |= bit(internal_node_id_1);
+    ++links_count_;
+    return;
   }
-  else {
-    links_.insert(std::make_pair(internal_node_id_2,internal_node_id_1));
-  }
-  #if MEMORY_OPTIMIZED == 0
-    ++internal_degrees_[internal_node_id_1];
-    ++internal_degrees_[internal_node_id_2];
-  #endif
+  bool inserted = is_narrow() ?
+    insert_link(narrow_adjacency_[internal_node_id_1], narrow_adjacency_[internal_node_id_2], internal_node_id_1, internal_node_id_2) :
+    insert_link(wide_adjacency_[internal_node_id_1], wide_adjacency_[internal_node_id_2], internal_node_id_1, internal_node_id_2);
+  if (inserted) ++links_count_;
   return;
 }
 void subgraph_t::fully_connect() {
+  if (is_dense()) {
+    for (id_t node = 0; node < size_in_nodes(); ++node)
+      rows_[node] = lowest_bits(size_in_nodes()) & ~bit(node);
+    links_count_ = size_in_nodes() * (size_in_nodes() - 1) / 2;
+    return;
+  }
   for (id_t node1 = 0; node1 < size_in_nodes(); ++node1) {
     for (id_t node2 = node1+1; node2 < size_in_nodes(); ++node2) {
       connect(node1,node2);
@@ -152,4 +223,42 @@ void subgraph_t::fully_connect() {
   return;
 }
 
-bool subgraph_t::node_exists(id_t internal_node_id) const {return internal_node_id < size_in_nodes();}
\ No newline at end of file
+bool subgraph_t::node_exists(id_t internal_node_id) const {return internal_node_id < size_in_nodes();}
+bool subgraph_t::are_neighbors(id_t internal_node_id_1, id_t internal_node_id_2) const {
+  assert(node_exists(internal_node_id_1) && node_exists(internal_node_id_2));
+  if (is_dense()) return (rows_[internal_node_id_1] & bit(internal_node_id_2)) != 0;
+  if (is_narrow()) {
+    const arena_vector_t<narrow_id_t> & neighbors = narrow_adjacency_[internal_node_id_1];
+    return std::binary_search(neighbors.begin(),neighbors.end(),(narrow_id_t) internal_node_id_2);
+  }
+  const arena_vector_t<id_t> & neighbors = wide_adjacency_[internal_node_id_1];
+  return std::binary_search(neighbors.begin(),neighbors.end(),internal_node_id_2);
+}
+bool subgraph_t::is_dense() const {return size_in_nodes() <= dense_capacity;}
+bool subgraph_t::is_narrow() const {return size_in_nodes() > dense_capacity && size_in_nodes() <= narrow_capacity;}
+
+// ============================================================================================
+// PRIVATE ====================================================================================
+// ============================================================================================
+
+void subgraph_t::promote() {
+  // rows_ holds the first dense_capacity nodes, the last node (already mapped) is isolated.
+  narrow_adjacency_.reserve(size_in_nodes());
+  for (id_t node = 0; node < size_in_nodes(); ++node) narrow_adjacency_.emplace_back(narrow_adjacency_.get_allocator());
+  for (id_t node = 0; node < rows_.size(); ++node) {
+    narrow_adjacency_[node].reserve(popcount(rows_[node]) + 1);
+    for (uint64_t word = rows_[node]; word != 0; word &= word - 1)
+      narrow_adjacency_[node].push_back((narrow_id_t) __builtin_ctzll(word));
+  }
+  arena_vector_t< uint64_t >(rows_.get_allocator()).swap(rows_);
+  return;
+}
+void subgraph_t::widen() {
+  // narrow_adjacency_ holds the first narrow_capacity nodes, the last node (already mapped) is isolated.
+  wide_adjacency_.reserve(size_in_nodes());
+  for (id_t node = 0; node < size_in_nodes(); ++node) wide_adjacency_.emplace_back(wide_adjacency_.get_allocator());
+  for (id_t node = 0; node < narrow_adjacency_.size(); ++node)
+    wide_adjacency_[node].assign(narrow_adjacency_[node].begin(),narrow_adjacency_[node].end());
+  arena_vector_t< arena_vector_t<narrow_id_t> >(narrow_adjacency_.get_allocator()).swap(narrow_adjacency_);
+  return;
+}
@@ -15,12 +15,14 @@
 // C libraries
 #include <assert.h> // error checking: turn off with #define NDEBUG
 #include <stddef.h> // size_t
+#include <stdint.h> // uint64_t (bitset rows), uint16_t (narrow identifiers)
 // STL
-#include <set> // set of edge_t
-#include <map> // local id to global id
-#include <vector> // internal degrees
-#include <algorithm> //set_difference
+#include <set> // set of edge_t (accessors)
+#include <vector> // adjacency lists
+#include <algorithm> // lower_bound, upper_bound
 #include <utility>  // std::pair
+// Project files
+#include "arena.hpp" // arena_vector_t
 // Typdef and helpers
 #include "types.hpp" // edge_t, id_t
   
@@ -29,17 +31,42 @@
 
 /** @class subgraph_t
   * @brief Subgraph class for modular networks.
+  *
+  * Links of small subgraphs (at most @p dense_capacity nodes) are stored as 
+  * one 64-bit row per node, where bit j of row i is set if i and j are neighbors.
+  * Degrees are popcounts and link creation targets are selected among the zero 
+  * bits of a row in a handful of word operations. 
+  *
+  * Subgraphs are promoted to sorted adjacency lists of internal identifiers 
+  * once they grow past @p dense_capacity nodes. The neighborhood of a node is 
+  * then available in O(1) and its degree is the size of its list. Internal 
+  * identifiers are stored on 16 bits (@p narrow_id_t) as long as the subgraph 
+  * has at most @p narrow_capacity nodes, and on 32 bits beyond.
+  *
+  * Internal identifiers are dense (0 to n-1), so that the global identifiers
+  * are stored in a plain vector indexed by internal identifier.
+  *
+  * Every container draws its memory from the arena given at construction, if any.
   */
 class subgraph_t {
 public:
+  /// Largest subgraph that is stored as bitset rows (one machine word per row).
+  static const size_t dense_capacity = 64;
+  /// Internal identifier of the nodes of sparse subgraphs with at most @p narrow_capacity nodes.
+  typedef uint16_t narrow_id_t;
+  /// Largest subgraph whose adjacency lists are stored with @p narrow_id_t.
+  static const size_t narrow_capacity = (size_t) UINT16_MAX + 1;
+
   /** @name Constructor
     * Available constructors for the subgraph_t class.
     */
   //@{
   /// Empty constructor
-  subgraph_t();
+  explicit subgraph_t(arena_t * arena = nullptr);
   /// Constructor with a initial list of nodes
-  subgraph_t(std::set< id_t > nodes, bool connected);
+  subgraph_t(std::set< id_t > nodes, bool connected, arena_t * arena = nullptr);
+  /// Constructor with a sorted range of nodes, possibly with duplicates (each distinct node is added once)
+  subgraph_t(const id_t * first, const id_t * last, bool connected, arena_t * arena = nullptr);
   //@}
 
   /** @name Capacity 
@@ -48,18 +75,29 @@ public:
   //@{
   size_t size_in_links() const;
   size_t size_in_nodes() const;
+  /** Number of pairs of nodes that are not connected yet, i.e. n(n-1)/2 - m. */
+  size_t missing_links() const;
+  /** True if every pair of nodes is connected. Complexity: O(1). */
+  bool is_complete() const;
   //@}
 
   /** @name Accessors 
     * Return information relative to the subgraph structure.
     */
   //@{
-  /// Get internal degrees 
+  /// Get internal degrees (copy, see internal_degree for a direct access)
   std::vector< unsigned int > get_internal_degrees() const;
-  /** Return a links of the subgraph (identified by local identifiers) */
+  /// Get the internal degree of a single node. Complexity: O(1).
+  size_t internal_degree(id_t internal_node_id) const;
+  /** Return a links of the subgraph (identified by local identifiers). Copy, see for_each_link. */
   std::set< edge_t > get_local_links() const;
-  /** Return the links of the subgraph (identified by global identifiers) */
+  /** Return the links of the subgraph (identified by global identifiers). Copy, see for_each_link. */
   std::multiset< edge_t > get_global_links() const;
+  /** Call @p visitor(internal_node_id_1, internal_node_id_2) once per link, with 
+    * internal_node_id_1 < internal_node_id_2, in lexicographic order. No copy is made.
+    * @param[in] <visitor> Callable object with signature void(id_t, id_t).
+    */
+  template <typename visitor_t> void for_each_link(visitor_t visitor) const;
   /** Retun the global identifier of a node */
   id_t get_global_id(id_t internal_node_id) const;
   /** Retun the global identifier of all nodes */
@@ -73,20 +111,25 @@ public:
     * manipulates the structure of the subgraph.
     */
   //@{
-  /** Create a set of nodes that are NOT part of the neighborhood of @p internal_node_id 
+  /** Create a sorted list of nodes that are NOT part of the neighborhood of @p internal_node_id 
     * but that are part of the subgraph, i.e. potential link creation targets.
-    * @remark Complexity: Neighbor reserach is O( n log(m) ) [because we use edge lists, 
-    *                     with adj lists it would be O(log(n)) or O(1), depending on 
-    *                     the implementation]. The set difference operation is O(n).
+    * @remark Complexity: Neighbor research is O(1) (adjacency list), the complement is O(n).
     * @param[in] <internal_node_id> Identifier of the first node in the subgraph.
     */
-  std::set<id_t> link_creation_targets(id_t internal_node_id);
+  std::vector<id_t> link_creation_targets(id_t internal_node_id) const;
+  /** Return the @p rank -th element of link_creation_targets(internal_node_id), without 
+    * building the list.
+    * @remark Complexity: O(degree), no allocation.
+    * @param[in] <internal_node_id> Identifier of the link creating node in the subgraph.
+    * @param[in] <rank> 0-based rank of the target, smaller than size_in_nodes() - 1 - internal_degree(internal_node_id).
+    */
+  id_t link_creation_target(id_t internal_node_id, size_t rank) const;
   /** Add a new node to the subgraph 
     * @param[in] <global_node_id> Identifier of the node in the original network.
     * @return Unique internal identifier of the node.
     */
   id_t add_node(id_t global_node_id);
-  /** Connect two nodes, 
+  /** Connect two nodes. Connecting two nodes that are already neighbors does nothing.
     * @param[in] <internal_node_id_1> Identifier of the first node in the subgraph.
     * @param[in] <internal_node_id_2> Identifier of the second node in the subgraph.
     * @warning The interface is somewhat inconsistent -- connect(2) uses
@@ -102,22 +145,36 @@ public:
   /** @name Boolean tests. */
   //@{
   bool node_exists(id_t internal_node_id) const;
+  bool are_neighbors(id_t internal_node_id_1, id_t internal_node_id_2) const;
+  /// True if links are stored as bitset rows.
+  bool is_dense() const;
+  /// True if links are stored as adjacency lists of @p narrow_id_t.
+  bool is_narrow() const;
   //@}
 
 private:
   /** @name Private data members */
   //@{
-  /// Link container
-  std::set< edge_t > links_; 
-  /// Identifier mapping : global_id = id_map_[internal_id]
-  std::map<id_t,id_t> id_map_;
-  #if MEMORY_OPTIMIZED == 0
-    /// Internal degree vectors (only defined if the MEMORY_OPTIMIZED macro is defined to 0)
-    std::vector< unsigned int > internal_degrees_;
-    std::set< id_t > nodes_;
-  #endif
+  /// Link container (dense subgraphs): bit j of rows_[internal_id] is set if j is a neighbor of internal_id.
+  arena_vector_t< uint64_t > rows_;
+  /// Link container (sparse subgraphs): narrow_adjacency_[internal_id] is the sorted list of the neighbors of internal_id.
+  arena_vector_t< arena_vector_t<narrow_id_t> > narrow_adjacency_;
+  /// Link container (large subgraphs): same as narrow_adjacency_, with full width identifiers.
+  arena_vector_t< arena_vector_t<id_t> > wide_adjacency_;
+  /// Number of links.
+  size_t links_count_;
+  /// Identifier mapping : global_id = global_ids_[internal_id]
+  arena_vector_t<id_t> global_ids_;
   //@}
 
+  /** Convert the bitset rows to narrow adjacency lists. */
+  void promote();
+  /** Convert the narrow adjacency lists to wide adjacency lists. */
+  void widen();
+  /** Visit the links stored in an adjacency list container (see for_each_link). */
+  template <typename adjacency_t, typename visitor_t> 
+  static void for_each_link_in(const adjacency_t & adjacency, visitor_t & visitor);
+
   /*  On the uniqueness of node IDs:
    *  Unique nodes (within the network) may appear multiple time in a same
    *  subgraph in the context of preferential attachment (SPA*). 
@@ -126,4 +183,27 @@ private:
    */
 };
 
+template <typename visitor_t> 
+void subgraph_t::for_each_link(visitor_t visitor) const {
+  if (!is_dense()) {
+    if (is_narrow()) for_each_link_in(narrow_adjacency_, visitor);
+    else for_each_link_in(wide_adjacency_, visitor);
+    return;
+  }
+  for (id_t node1 = 0; node1 < rows_.size(); ++node1) {
+    // only visit neighbors that follow node1 (the link is stored in the row of both nodes)
+    uint64_t word = node1 + 1 < 64 ? rows_[node1] & ~(((uint64_t) 1 << (node1 + 1)) - 1) : 0;
+    for (; word != 0; word &= word - 1) visitor(node1, (id_t) __builtin_ctzll(word));
+  }
+  return;
+}
+template <typename adjacency_t, typename visitor_t> 
+void subgraph_t::for_each_link_in(const adjacency_t & adjacency, visitor_t & visitor) {
+  for (id_t node1 = 0; node1 < adjacency.size(); ++node1) {
+    auto it = std::upper_bound(adjacency[node1].begin(),adjacency[node1].end(),node1);
+    for (; it != adjacency[node1].end(); ++it) visitor(node1, (id_t) *it);
+  }
+  return;
+}
+
 #endif //SUBGRAPH_HPP
\ No newline at end of file
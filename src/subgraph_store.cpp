@@ -0,0 +1,66 @@
+#include "subgraph_store.hpp"
+
+// STL
+#include <new> // placement new
+#include <utility> // std::move
+
+// ============================================================================================
+// PUBLIC =====================================================================================
+// ============================================================================================
+
+// CTOR
+subgraph_store_t::subgraph_store_t(arena_t & arena) : arena_(arena) { }
+subgraph_store_t::~subgraph_store_t() {
+  // O(number of chunks): the content of the subgraphs is released with the arena.
+  for (auto it = chunks_.begin(); it != chunks_.end(); ++it) ::operator delete(*it);
+}
+
+// CAPACITY
+void subgraph_store_t::reserve(size_t n) {
+  hot_.reserve(n);
+  chunks_.reserve(n / chunk_capacity + 1);
+}
+void subgraph_store_t::clear() {
+  for (id_t cluster = 0; cluster < size(); ++cluster) cold(cluster).~subgraph_t();
+  for (auto it = chunks_.begin(); it != chunks_.end(); ++it) ::operator delete(*it);
+  hot_.clear();
+  chunks_.clear();
+}
+
+// MODIFIERS
+id_t subgraph_store_t::emplace_back(const id_t * first, const id_t * last, bool connected) {
+  if (size() == chunks_.size() * chunk_capacity) {
+    chunks_.push_back(static_cast<subgraph_t*>(::operator new(chunk_capacity * sizeof(subgraph_t))));
+  }
+  hot_.push_back(hot_t());
+  id_t cluster = (id_t) size() - 1;
+  new (&cold(cluster)) subgraph_t(first, last, connected, &arena_);
+  sync(cluster);
+  return cluster;
+}
+id_t subgraph_store_t::add_node(id_t cluster, id_t global_node_id) {
+  id_t internal_node_id = cold(cluster).add_node(global_node_id);
+  ++hot_[cluster].nodes;
+  return internal_node_id;
+}
+void subgraph_store_t::connect(id_t cluster, id_t internal_node_id_1, id_t internal_node_id_2) {
+  cold(cluster).connect(internal_node_id_1, internal_node_id_2);
+  hot_[cluster].links = cold(cluster).size_in_links(); // connecting neighbors does nothing
+}
+void subgraph_store_t::clear(id_t cluster) {
+  cold(cluster).clear();
+  sync(cluster);
+}
+void subgraph_store_t::replace(id_t cluster, subgraph_t && subgraph) {
+  cold(cluster) = std::move(subgraph);
+  sync(cluster);
+}
+
+// ============================================================================================
+// PRIVATE ====================================================================================
+// ============================================================================================
+
+void subgraph_store_t::sync(id_t cluster) {
+  hot_[cluster].nodes = cold(cluster).size_in_nodes();
+  hot_[cluster].links = cold(cluster).size_in_links();
+}
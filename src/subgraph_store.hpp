@@ -0,0 +1,145 @@
+#ifndef SUBGRAPH_STORE_HPP
+#define SUBGRAPH_STORE_HPP
+/**
+  * @file subgraph_store.hpp
+  * @brief Network-wide container of the subgraphs of a modular network.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <assert.h> // error checking: turn off with #define NDEBUG
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+// STL
+#include <vector>   // hot records and chunks
+// Project files
+#include "arena.hpp" // arena_t
+#include "subgraph.hpp" // subgraph_t
+// Typdef and helpers
+#include "types.hpp" // id_t
+
+/** @class subgraph_store_t
+  * @brief Network-wide container of subgraphs, indexed by cluster identifier.
+  *
+  *  The fields that are read at every SPA step (size in nodes and links) are
+  *  kept in a dense array of 16 bytes records, such that the uniform picks and
+  *  the completeness test of a community only touch one cache line. 
+  *
+  *  The subgraph objects themselves (identifiers and links) are cold data: they
+  *  are stored in chunks of @p chunk_capacity objects whose storage is allocated
+  *  once, such that growing the store never moves (nor copies) existing subgraphs.
+  *  Their containers draw their memory from the arena of the owner of the store. 
+  *
+  *  Subgraphs are modified through the store, which keeps both views in sync.
+  *
+  *  @warning The destructor does not destroy the subgraphs one by one: their memory 
+  *    belongs to the arena, which must be released after the store is destroyed.
+  */
+class subgraph_store_t {
+public:
+  /// Number of subgraph objects per chunk of cold storage.
+  static const size_t chunk_capacity = 1024;
+
+  /** @name Constructor */
+  //@{
+  /** @param[in] <arena> Arena of the subgraph containers, must outlive the store. */
+  explicit subgraph_store_t(arena_t & arena);
+  ~subgraph_store_t();
+  //@}
+
+  /** @name Capacity */
+  //@{
+  /** Number of subgraphs in the store. */
+  size_t size() const;
+  /** Reserve memory for @p n subgraphs. */
+  void reserve(size_t n);
+  /** Destroy every subgraph. */
+  void clear();
+  //@}
+
+  /** @name Accessors */
+  //@{
+  /** Size in nodes of a subgraph (hot data). */
+  size_t size_in_nodes(id_t cluster) const;
+  /** Size in links of a subgraph (hot data). */
+  size_t size_in_links(id_t cluster) const;
+  /** True if every pair of nodes of a subgraph is connected (hot data). */
+  bool is_complete(id_t cluster) const;
+  /** Read-only view of a subgraph (cold data). */
+  const subgraph_t & operator[](id_t cluster) const;
+  //@}
+
+  /** @name Modifiers */
+  //@{
+  /** Construct a subgraph at the end of the store (see subgraph_t::subgraph_t). 
+    * @return The identifier of the subgraph, i.e. size()-1. 
+    */
+  id_t emplace_back(const id_t * first, const id_t * last, bool connected);
+  /** Add a node to a subgraph (see subgraph_t::add_node). */
+  id_t add_node(id_t cluster, id_t global_node_id);
+  /** Connect two nodes of a subgraph (see subgraph_t::connect). */
+  void connect(id_t cluster, id_t internal_node_id_1, id_t internal_node_id_2);
+  /** Clear the content of a subgraph, without changing the identifiers of the others. */
+  void clear(id_t cluster);
+  /** Replace a subgraph by @p subgraph, whose containers may draw from another arena.
+    * @remark Distinct clusters may be replaced concurrently, provided that the replaced
+    *   subgraphs are empty (no memory is returned to the arena of the store).
+    */
+  void replace(id_t cluster, subgraph_t && subgraph);
+  //@}
+
+private:
+  subgraph_store_t(const subgraph_store_t &);
+  subgraph_store_t & operator=(const subgraph_store_t &);
+
+  /// Hot fields of a subgraph.
+  struct hot_t {
+    uint64_t nodes;
+    uint64_t links;
+  };
+
+  subgraph_t & cold(id_t cluster);
+  const subgraph_t & cold(id_t cluster) const;
+  /** Copy the hot fields of a subgraph from its cold storage. */
+  void sync(id_t cluster);
+
+  /** @name Private data members */
+  //@{
+  /// Arena of the subgraph containers.
+  arena_t & arena_;
+  /// Hot fields, indexed by cluster.
+  std::vector<hot_t> hot_;
+  /// Cold storage: subgraph c is chunks_[c / chunk_capacity][c % chunk_capacity].
+  std::vector< subgraph_t* > chunks_;
+  //@}
+};
+
+// Hot accessors are defined inline: they are called at every SPA step.
+inline size_t subgraph_store_t::size() const {return hot_.size();}
+inline size_t subgraph_store_t::size_in_nodes(id_t cluster) const {
+  assert(cluster < size());
+  return hot_[cluster].nodes;
+}
+inline size_t subgraph_store_t::size_in_links(id_t cluster) const {
+  assert(cluster < size());
+  return hot_[cluster].links;
+}
+inline bool subgraph_store_t::is_complete(id_t cluster) const {
+  assert(cluster < size());
+  return hot_[cluster].nodes * (hot_[cluster].nodes - 1) / 2 == hot_[cluster].links;
+}
+inline const subgraph_t & subgraph_store_t::operator[](id_t cluster) const {return cold(cluster);}
+inline const subgraph_t & subgraph_store_t::cold(id_t cluster) const {
+  assert(cluster < size());
+  return chunks_[cluster / chunk_capacity][cluster % chunk_capacity];
+}
+inline subgraph_t & subgraph_store_t::cold(id_t cluster) {
+  assert(cluster < size());
+  return chunks_[cluster / chunk_capacity][cluster % chunk_capacity];
+}
+
+#endif //SUBGRAPH_STORE_HPP
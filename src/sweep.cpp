@@ -0,0 +1,247 @@
+#include "sweep.hpp"
+
+// C libraries
+#include <stdlib.h> // strtod
+#include <math.h>   // floor, pow
+#include <limits.h> // UINT_MAX
+// STL
+#include <algorithm> // std::find, std::max, std::stable_sort
+#include <utility>  // std::pair (fingerprint)
+#include <fstream>  // manifest file
+#include <sstream>  // specification tokens, labels
+#include <iomanip>  // std::setw, std::setfill, std::setprecision
+// Logger
+#include "includes/logger.hpp" // LOGGER macros
+
+// Specification parsing helpers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace {
+  /** Parse a number that spans the whole token. */
+  bool parse_number(const std::string & token, double & number) {
+    if (token.empty()) return false;
+    char * end;
+    number = strtod(token.c_str(), &end);
+    return *end == '\0';
+  }
+  /** Round @p value to 12 significant digits (0.1 + 3 * 0.2 is read as 0.7, not 0.7000000000000001). */
+  double round_significant(double value) {
+    std::ostringstream text;
+    text << std::setprecision(12) << value;
+    return strtod(text.str().c_str(), NULL);
+  }
+  /** Parse a list of values and ranges separated by commas (see expand_sweep(3)). */
+  bool parse_values(const std::string & list, std::vector<double> & values) {
+    std::stringstream items(list);
+    std::string item;
+    while (getline(items, item, ',')) {
+      std::vector<std::string> bounds;
+      std::stringstream item_stream(item);
+      std::string bound;
+      while (getline(item_stream, bound, ':')) bounds.push_back(bound);
+      double begin, end, step;
+      if (bounds.size() == 1 && parse_number(bounds[0], begin)) {
+        values.push_back(begin);
+      }
+      else if (bounds.size() == 3 && !bounds[2].empty() && bounds[2][0] == '*') {
+        // geometric range
+        if (!parse_number(bounds[0], begin) || !parse_number(bounds[1], end) || !parse_number(bounds[2].substr(1), step)) return false;
+        if (begin <= 0 || begin > end || step <= 1) return false;
+        for (unsigned int k = 0; begin * pow(step, k) <= end * (1 + 1e-9); ++k) values.push_back(round_significant(begin * pow(step, k)));
+      }
+      else if (bounds.size() == 3) {
+        // arithmetic range
+        if (!parse_number(bounds[0], begin) || !parse_number(bounds[1], end) || !parse_number(bounds[2], step)) return false;
+        if (begin > end || step <= 0) return false;
+        for (unsigned int k = 0; begin + k * step <= end + 1e-9 * step; ++k) values.push_back(round_significant(begin + k * step));
+      }
+      else return false;
+    }
+    return !values.empty();
+  }
+  /** Assign a value to the field @p name of @p point. */
+  bool assign_field(const std::string & name, double value, spa_parameters_t & point) {
+    if (name == "p") point.p.init(value);
+    else if (name == "q") point.q.init(value);
+    else if (name == "r") point.r.init(value);
+    else {
+      // integer fields (geometric ranges may yield values such as 999.9999999)
+      const double rounded = floor(value + 0.5);
+      if (fabs(value - rounded) > 1e-6 * (1 + rounded) || rounded < 0 || rounded > UINT_MAX) return false;
+      if (name == "basic_size" || name == "s") point.basic_size.init((unsigned int) rounded);
+      else if (name == "final_size" || name == "N") point.final_size.init((unsigned int) rounded);
+      else if (name == "initial_size" || name == "n") point.initial_size.init((unsigned int) rounded);
+      else return false;
+    }
+    return true;
+  }
+  /** Shortest decimal form of @p value that reads back to the same double (at least 6 significant digits). */
+  std::string lossless(double value) {
+    std::ostringstream text;
+    for (int precision = 6; precision <= 17; ++precision) {
+      text.str("");
+      text << std::setprecision(precision) << value;
+      if (strtod(text.str().c_str(), NULL) == value) break;
+    }
+    return text.str();
+  }
+}
+
+// ============================================================================================
+// PUBLIC =====================================================================================
+// ============================================================================================
+
+bool expand_sweep(const std::string & spec, const spa_parameters_t & base, std::vector<spa_parameters_t> & points) {
+  points.clear();
+  std::vector<std::string> names;
+  std::vector< std::vector<double> > axes;
+  std::stringstream fields(spec);
+  std::string field;
+  while (getline(fields, field, ';')) {
+    if (field.empty()) continue;
+    const size_t equal = field.find('=');
+    std::vector<double> values;
+    spa_parameters_t test;
+    if (equal == std::string::npos || !parse_values(field.substr(equal + 1), values) || !assign_field(field.substr(0, equal), values[0], test) ||
+        std::find(names.begin(), names.end(), field.substr(0, equal)) != names.end()) {
+      LOGGER_WRITE(Logger::ERROR, "Could not parse the sweep field '"+field+"'.")
+      return false;
+    }
+    names.push_back(field.substr(0, equal));
+    axes.push_back(values);
+  }
+  if (axes.empty()) {
+    LOGGER_WRITE(Logger::ERROR, "The sweep specification is empty.")
+    return false;
+  }
+  // Cartesian product, with the last axis varying fastest
+  std::vector<size_t> index(axes.size(), 0);
+  std::set<std::string> labels;
+  while (true) {
+    spa_parameters_t point = base;
+    for (size_t axis = 0; axis < axes.size(); ++axis) {
+      if (!assign_field(names[axis], axes[axis][index[axis]], point)) {
+        LOGGER_WRITE(Logger::ERROR, "Forbidden value of the sweep field "+names[axis]+": "+VAR_EVAL(axes[axis][index[axis]])+".")
+        return false;
+      }
+    }
+    if (!labels.insert(sweep_label(point)).second) {
+      LOGGER_WRITE(Logger::ERROR, "The sweep specification repeats the grid point "+sweep_label(point)+".")
+      return false;
+    }
+    points.push_back(point);
+    size_t axis = axes.size();
+    while (axis > 0 && ++index[axis - 1] == axes[axis - 1].size()) index[--axis] = 0;
+    if (axis == 0) break;
+  }
+  return true;
+}
+std::string sweep_label(const spa_parameters_t & point) {
+  std::ostringstream label;
+  label << "p" << lossless(point.p.value) << "_q" << lossless(point.q.value) << "_r" << lossless(point.r.initialized ? point.r.value : 0)
+        << "_s" << point.basic_size.value << "_N" << point.final_size.value << "_n" << point.initial_size.value << "_";
+  return label.str();
+}
+
+std::string sweep_fingerprint(const spa_parameters_t & prog_params) {
+  std::ostringstream fingerprint;
+  fingerprint << "seed=" << prog_params.seed.value << " engine=" << prog_params.engine.value
+              << " realizations=" << prog_params.realizations.value << " realization=" << prog_params.realization.value << " minimal_size=" << prog_params.minimal_size.value
+              << " deferred_links=" << prog_params.deferred_links.value << " relaxed=" << lossless(prog_params.relaxed.value)
+              << " validate_relaxed=" << prog_params.validate_relaxed.value << " format=" << prog_params.format.value
+              << " append=" << prog_params.append.value;
+  // outputs, in the order of the options
+  const std::pair<const char *, const str_opt_t *> outputs[] = {
+    {"edge_list", &prog_params.edge_list}, {"connected_edge_list", &prog_params.connected_edge_list},
+    {"cluster_contents", &prog_params.cluster_contents}, {"node_participations", &prog_params.node_participations},
+    {"cluster_sizes", &prog_params.cluster_sizes}, {"node_memberships", &prog_params.node_memberships},
+    {"degrees", &prog_params.degrees}, {"connected_degrees", &prog_params.connected_degrees},
+    {"internal_degrees", &prog_params.internal_degrees}, {"projected_internal_degrees", &prog_params.projected_internal_degrees},
+    {"collapsed_internal_degrees", &prog_params.collapsed_internal_degrees}, {"timer", &prog_params.timer}
+  };
+  for (size_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); ++i) {
+    if (outputs[i].second->initialized) fingerprint << " " << outputs[i].first << "=" << outputs[i].second->value;
+  }
+  return fingerprint.str();
+}
+std::string sweep_manifest_path(const spa_parameters_t & prog_params) {return prog_params.base_path.value + "sweep_manifest.txt";}
+
+void plan_batch(const spa_parameters_t & prog_params, realization_batch_t & batch) {
+  batch = realization_batch_t();
+  std::vector<spa_parameters_t> points(1, prog_params);
+  if (prog_params.sweep.initialized) {
+    expand_sweep(prog_params.sweep.value, prog_params, points); // validated by test_parameters(1)
+    // the longest realizations start first, and the shorter ones fill the threads at the end
+    std::stable_sort(points.begin(), points.end(), [](const spa_parameters_t & a, const spa_parameters_t & b) {
+      return a.final_size.value > b.final_size.value;
+    });
+  }
+  for (auto point = points.begin(); point != points.end(); ++point) {
+    const std::string group = prog_params.sweep.initialized ? sweep_label(*point) : "ensemble";
+    point->sweep.initialized = false;
+    if (prog_params.sweep.initialized) point->base_path.value = prog_params.base_path.value + group;
+    for (unsigned int realization = 0; realization < prog_params.realizations.value; ++realization) {
+      spa_parameters_t params = prog_params.realizations.value > 1 ? realization_parameters(*point, realization) : *point;
+      // the realizations already occupy the threads
+      params.threads.value = 1;
+      batch.params.push_back(params);
+      batch.labels.push_back(params.base_path.value.substr(prog_params.base_path.value.size()));
+      batch.groups.push_back(group);
+    }
+  }
+  return;
+}
+spa_parameters_t realization_parameters(const spa_parameters_t & prog_params, unsigned int realization) {
+  spa_parameters_t params = prog_params;
+  std::ostringstream width;
+  width << prog_params.realizations.value - 1;
+  std::ostringstream prefix;
+  prefix << prog_params.base_path.value << "r" << std::setw(width.str().size()) << std::setfill('0') << realization << "_";
+  params.base_path.value = prefix.str();
+  params.realization.value = realization;
+  params.realizations.value = 1;
+  return params;
+}
+size_t estimated_footprint(const spa_parameters_t & prog_params) {
+  double bytes_per_node = 96;
+  if (prog_params.links_requested()) {
+    // about (1 + r(1-p)) links per structural event, and 1/q structural events per node
+    const double q = std::max(prog_params.q.value, 1e-3);
+    bytes_per_node += 64 * (1 + prog_params.r.value * (1 - prog_params.p.value)) / q;
+  }
+  return (size_t) (bytes_per_node * prog_params.final_size.value);
+}
+
+// ============================================================================================
+// sweep_manifest_t ===========================================================================
+// ============================================================================================
+
+const std::string sweep_manifest_t::header_prefix = "# parameters: ";
+
+sweep_manifest_t::sweep_manifest_t(const std::string & path, const std::string & fingerprint) : path_(path), fingerprint_(fingerprint), headed_(false), compatible_(true) {
+  std::ifstream file(path_.c_str(), std::ios::in);
+  std::string label;
+  while (getline(file, label)) {
+    if (label.compare(0, header_prefix.size(), header_prefix) == 0) {
+      headed_ = true;
+      compatible_ = compatible_ && label.substr(header_prefix.size()) == fingerprint_;
+    }
+    else if (!label.empty()) {
+      // labels before the header come from an unknown set of parameters
+      compatible_ = compatible_ && headed_;
+      completed_.insert(label);
+    }
+  }
+}
+bool sweep_manifest_t::compatible() const {return compatible_;}
+bool sweep_manifest_t::completed(const std::string & label) const {return compatible_ && completed_.count(label) > 0;}
+void sweep_manifest_t::record(const std::string & label) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ofstream file(path_.c_str(), std::ios::out | std::ios::app);
+  if (!headed_) {
+    file << header_prefix << fingerprint_ << "\n";
+    headed_ = true;
+  }
+  file << label << "\n";
+  file.flush();
+  if (!file.good()) {LOGGER_WRITE(Logger::ERROR, "Could not record "+label+" in the sweep manifest "+path_+".")}
+  return;
+}
@@ -0,0 +1,114 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+/**
+  * @file sweep.hpp
+  * @brief Batches of realizations (ensembles and parameter sweeps), and manifest of the completed ones.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <stddef.h> // size_t
+// STL
+#include <string> // specifications, labels
+#include <vector> // grid points, batches
+#include <set>    // completed labels
+#include <mutex>  // sweep_manifest_t::record(1)
+// Typdef and helpers
+#include "types.hpp" // spa_parameters_t
+
+/** @name Parameter sweeps */
+//@{
+/** @name expand_sweep
+  * Expand a grid specification into the Cartesian product of its values.
+  * The specification lists fields and their values, separated by semicolons and
+  * without spaces, e.g. "p=0.1,0.2;q=0.1:0.9:0.2;N=1000:1000000:*10", where a:b:c
+  * is the range from a to b by steps of c, and a:b:*c the range from a to b by
+  * factors of c. The fields are p, q, r, basic_size (s), final_size (N) and
+  * initial_size (n).
+  * @remark Return by reference.
+  * @param[in] <spec> Grid specification.
+  * @param[in] <base> Parameters of every point, besides the swept fields.
+  * @param[out] <points> Parameters of the grid points (the last field of the specification varies fastest).
+  * @return false if the specification cannot be parsed, or if it repeats a grid point (the error is logged).
+  */
+bool expand_sweep(const std::string & spec, const spa_parameters_t & base, std::vector<spa_parameters_t> & points);
+/** Label of a grid point, e.g. "p0.1_q0.5_r1_s2_N1000_n1_" (output prefix and manifest key).
+  * The rates are written with the fewest digits (at least 6) that identify them exactly,
+  * such that distinct grid points have distinct labels.
+  */
+std::string sweep_label(const spa_parameters_t & point);
+//@}
+
+/** @class realization_batch_t
+  * @brief Realizations of an ensemble or of a sweep.
+  */
+typedef struct realization_batch_t {
+  /// Parameters of the realizations (realization indices, prefixed base paths, sequential parallel steps).
+  std::vector<spa_parameters_t> params;
+  /// Output prefixes, relative to the base path of the batch (manifest keys).
+  std::vector<std::string> labels;
+  /// Labels of the points, shared by the realizations of the same parameters.
+  std::vector<std::string> groups;
+} realization_batch_t;
+
+/** @name Batches */
+//@{
+/** @name plan_batch
+  * Realizations of the ensemble (-k) or sweep (-w) mode, in the order in which
+  * they should start: the points with the largest final sizes first, then by
+  * realization.
+  * @remark Return by reference. The plan only depends on the parameters.
+  * @param[in] <prog_params> Parsed (and validated) program parameters.
+  * @param[out] <batch> Planned realizations.
+  */
+void plan_batch(const spa_parameters_t & prog_params, realization_batch_t & batch);
+/** Parameters of the realization @p realization of an ensemble: realization index (same seed) and prefixed outputs. */
+spa_parameters_t realization_parameters(const spa_parameters_t & prog_params, unsigned int realization);
+/** Options that the labels do not describe, besides the swept fields and the base path, e.g.
+  * "seed=42 engine=mt19937 ... edge_list=edges.txt" (header of the manifest).
+  */
+std::string sweep_fingerprint(const spa_parameters_t & prog_params);
+/** Path of the manifest of a sweep (in its base path). */
+std::string sweep_manifest_path(const spa_parameters_t & prog_params);
+/** Estimated peak memory of a realization, in bytes (structure, plus subgraphs and edge list in complete simulation mode). */
+size_t estimated_footprint(const spa_parameters_t & prog_params);
+//@}
+
+/** @class sweep_manifest_t
+  * @brief File that records the completed tasks of a sweep, one label per line,
+  *        such that an interrupted sweep resumes where it stopped.
+  *
+  *  The first line records the options of the sweep (sweep_fingerprint(1)): a run
+  *  with other options does not resume from the manifest (see compatible()).
+  */
+class sweep_manifest_t {
+public:
+  /// Prefix of the header line.
+  static const std::string header_prefix;
+
+  /** Load the labels already recorded in the file @p path, if it exists.
+    * @param[in] <path> Path of the manifest.
+    * @param[in] <fingerprint> Options of the current run (sweep_fingerprint(1)).
+    */
+  sweep_manifest_t(const std::string & path, const std::string & fingerprint);
+  /** False if the file records labels of a run with other options (or without a header). */
+  bool compatible() const;
+  /** True if the task @p label was recorded when the manifest was loaded, by a run with the same options. */
+  bool completed(const std::string & label) const;
+  /** Append the label of a completed task to the file, after the header if the file has none (thread-safe, flushed immediately). */
+  void record(const std::string & label);
+
+private:
+  std::string path_;
+  std::string fingerprint_;
+  bool headed_;
+  bool compatible_;
+  std::set<std::string> completed_;
+  std::mutex mutex_;
+};
+
+#endif //SWEEP_HPP
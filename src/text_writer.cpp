@@ -0,0 +1,75 @@
+#include "text_writer.hpp"
+
+// C libraries
+#include <stdio.h> // snprintf (doubles)
+#include <stdint.h> // uintptr_t
+// STL
+#include <algorithm> // std::max, std::min
+
+// Tables ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace text_writer_tables {
+  const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+  const uint64_t powers_of_10[20] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull
+  };
+}
+
+// Helpers ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace {
+  /// Alignment of the buffer (pages).
+  const size_t buffer_alignment = 4096;
+  /// Smallest buffer: room for any number.
+  const size_t minimal_capacity = 64;
+}
+
+// ============================================================================================
+// PUBLIC =====================================================================================
+// ============================================================================================
+
+text_writer_t::text_writer_t(std::ostream & os, size_t capacity) : os_(os) {
+  capacity = std::max(capacity, minimal_capacity);
+  memory_.reset(new char[capacity + buffer_alignment]);
+  const uintptr_t address = (uintptr_t) memory_.get();
+  begin_ = memory_.get() + (buffer_alignment - address % buffer_alignment) % buffer_alignment;
+  cursor_ = begin_;
+  end_ = begin_ + capacity;
+}
+text_writer_t::~text_writer_t() {flush();}
+text_writer_t & text_writer_t::operator<<(double value) {
+  // "%g" is the format of std::ostream with its default flags and precision (6)
+  reserve(32);
+  cursor_ += snprintf(cursor_, 32, "%g", value);
+  return *this;
+}
+void text_writer_t::flush() {
+  drain();
+  os_.flush();
+  return;
+}
+
+// ============================================================================================
+// PRIVATE ====================================================================================
+// ============================================================================================
+
+void text_writer_t::drain() {
+  if (cursor_ > begin_) os_.write(begin_, cursor_ - begin_);
+  cursor_ = begin_;
+  return;
+}
+void text_writer_t::put_text(const char * text, size_t length) {
+  while (length > 0) {
+    reserve(std::min(length, (size_t) (end_ - begin_)));
+    const size_t copied = std::min(length, (size_t) (end_ - cursor_));
+    memcpy(cursor_, text, copied);
+    cursor_ += copied;
+    text += copied;
+    length -= copied;
+  }
+  return;
+}
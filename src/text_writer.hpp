@@ -0,0 +1,134 @@
+#ifndef TEXT_WRITER_HPP
+#define TEXT_WRITER_HPP
+/**
+  * @file text_writer.hpp
+  * @brief Buffered text output of integers, with a fast decimal conversion.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <stdint.h> // uint32_t, uint64_t
+#include <stddef.h> // size_t
+#include <string.h> // memcpy
+// STL
+#include <iostream> // ostream
+#include <string>   // separators
+#include <memory>   // std::unique_ptr (buffer)
+
+/** @class text_writer_t
+  * @brief Formats numbers into a large page-aligned buffer, and hands it to a stream in single writes.
+  *
+  *  Integers are converted two digits at a time from a table, after their number of
+  *  digits is computed from their bit length, instead of going through the locale
+  *  and the virtual calls of std::ostream. The output is the one of std::ostream
+  *  with its default flags (doubles: 6 significant digits), such that the stream
+  *  only receives buffer-sized writes, e.g. a std::ofstream, whose own buffer is
+  *  bypassed by large writes, or std::cout.
+  *
+  *  The buffer is flushed by the destructor: the stream must outlive the writer.
+  */
+class text_writer_t {
+public:
+  /// Size of the buffer, by default.
+  static const size_t default_capacity = (size_t) 1 << 22;
+
+  /** @param[in] <os> Stream receiving the buffer.
+    * @param[in] <capacity> Size of the buffer, in bytes (at least 64).
+    */
+  explicit text_writer_t(std::ostream & os, size_t capacity = default_capacity);
+  ~text_writer_t();
+
+  /** @name Formatting */
+  //@{
+  text_writer_t & operator<<(unsigned int value);
+  text_writer_t & operator<<(unsigned long value);
+  text_writer_t & operator<<(unsigned long long value);
+  text_writer_t & operator<<(int value);
+  text_writer_t & operator<<(long value);
+  text_writer_t & operator<<(long long value);
+  text_writer_t & operator<<(double value);
+  text_writer_t & operator<<(char c);
+  text_writer_t & operator<<(const char * text);
+  text_writer_t & operator<<(const std::string & text);
+  //@}
+
+  /** Write the buffer to the stream, and flush the stream. */
+  void flush();
+
+private:
+  text_writer_t(const text_writer_t &) = delete;
+  text_writer_t & operator=(const text_writer_t &) = delete;
+
+  /** Make room for @p bytes bytes (at most the capacity). */
+  void reserve(size_t bytes);
+  /** Write the buffer to the stream. */
+  void drain();
+  void put_unsigned(uint64_t value);
+  void put_signed(int64_t value);
+  void put_text(const char * text, size_t length);
+
+  std::ostream & os_;
+  std::unique_ptr<char[]> memory_;
+  char * begin_;
+  char * cursor_;
+  char * end_;
+};
+
+// The conversions are defined inline: they are called once per number of every output.
+namespace text_writer_tables {
+  /// "00" to "99".
+  extern const char digit_pairs[201];
+  /// 10^i for i in [0, 19].
+  extern const uint64_t powers_of_10[20];
+}
+inline void text_writer_t::reserve(size_t bytes) {
+  if ((size_t) (end_ - cursor_) < bytes) drain();
+  return;
+}
+inline void text_writer_t::put_unsigned(uint64_t value) {
+  reserve(20);
+  // digits = floor(log10(value)) + 1, from the bit length (1233 / 4096 ~ log10(2))
+  const unsigned int bits = 64 - __builtin_clzll(value | 1);
+  unsigned int digits = (bits * 1233) >> 12;
+  digits += value >= text_writer_tables::powers_of_10[digits];
+  digits += digits == 0;
+  char * last = cursor_ + digits;
+  cursor_ = last;
+  while (value >= 100) {
+    const unsigned int pair = (unsigned int) (value % 100) * 2;
+    value /= 100;
+    last -= 2;
+    memcpy(last, text_writer_tables::digit_pairs + pair, 2);
+  }
+  if (value >= 10) memcpy(last - 2, text_writer_tables::digit_pairs + value * 2, 2);
+  else *(last - 1) = (char) ('0' + value);
+  return;
+}
+inline void text_writer_t::put_signed(int64_t value) {
+  if (value < 0) {
+    reserve(1);
+    *cursor_++ = '-';
+    put_unsigned(0 - (uint64_t) value);
+  }
+  else put_unsigned((uint64_t) value);
+  return;
+}
+inline text_writer_t & text_writer_t::operator<<(unsigned int value) {put_unsigned(value); return *this;}
+inline text_writer_t & text_writer_t::operator<<(unsigned long value) {put_unsigned(value); return *this;}
+inline text_writer_t & text_writer_t::operator<<(unsigned long long value) {put_unsigned(value); return *this;}
+inline text_writer_t & text_writer_t::operator<<(int value) {put_signed(value); return *this;}
+inline text_writer_t & text_writer_t::operator<<(long value) {put_signed(value); return *this;}
+inline text_writer_t & text_writer_t::operator<<(long long value) {put_signed(value); return *this;}
+inline text_writer_t & text_writer_t::operator<<(char c) {
+  reserve(1);
+  *cursor_++ = c;
+  return *this;
+}
+inline text_writer_t & text_writer_t::operator<<(const char * text) {put_text(text, strlen(text)); return *this;}
+inline text_writer_t & text_writer_t::operator<<(const std::string & text) {put_text(text.data(), text.size()); return *this;}
+
+#endif //TEXT_WRITER_HPP
@@ -0,0 +1,103 @@
+#include "thread_pool.hpp"
+
+// C libraries
+#if defined(__unix__) || defined(__APPLE__)
+  #include <unistd.h> // sysconf
+#endif
+// STL
+#include <algorithm> // std::max
+#include <exception> // std::exception_ptr
+#include <thread>    // std::thread
+
+// ============================================================================================
+// thread_pool_t ==============================================================================
+// ============================================================================================
+
+thread_pool_t::thread_pool_t(unsigned int threads) : next_queue_(0) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned int t = 0; t < threads; ++t) queues_.emplace_back(new queue_t());
+}
+unsigned int thread_pool_t::size() const {return (unsigned int) queues_.size();}
+void thread_pool_t::submit(const task_t & task) {
+  queues_[next_queue_]->tasks.push_back(task);
+  next_queue_ = (next_queue_ + 1) % queues_.size();
+  return;
+}
+void thread_pool_t::run() {
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  auto worker = [&](unsigned int id) {
+    task_t task;
+    while (next_task(id, task)) {
+      try {
+        task();
+      }
+      catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (unsigned int t = 1; t < queues_.size(); ++t) workers.emplace_back(worker, t);
+  worker(0); // the calling thread is the first worker
+  for (auto it = workers.begin(); it != workers.end(); ++it) it->join();
+  next_queue_ = 0;
+  if (error) std::rethrow_exception(error);
+  return;
+}
+bool thread_pool_t::next_task(unsigned int worker, task_t & task) {
+  {
+    queue_t & own = *queues_[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.front());
+      own.tasks.pop_front();
+      return true;
+    }
+  }
+  // tasks are never added during run(): a single sweep over the other queues is enough.
+  for (size_t offset = 1; offset < queues_.size(); ++offset) {
+    queue_t & victim = *queues_[(worker + offset) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+// ============================================================================================
+// memory_budget_t ============================================================================
+// ============================================================================================
+
+memory_budget_t::memory_budget_t(size_t bytes) : capacity_(bytes), reserved_(0) {
+  if (capacity_ == 0) capacity_ = physical_memory() / 4 * 3;
+  // unknown physical memory: no limit
+  if (capacity_ == 0) capacity_ = (size_t) -1;
+}
+size_t memory_budget_t::capacity() const {return capacity_;}
+void memory_budget_t::acquire(size_t bytes) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  released_.wait(lock, [&]() {return reserved_ == 0 || bytes <= capacity_ - reserved_;});
+  reserved_ += bytes;
+  return;
+}
+void memory_budget_t::release(size_t bytes) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reserved_ -= bytes;
+  }
+  released_.notify_all();
+  return;
+}
+size_t memory_budget_t::physical_memory() {
+  #if defined(_SC_PHYS_PAGES) && defined(_SC_PAGE_SIZE)
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages > 0 && page_size > 0) return (size_t) pages * (size_t) page_size;
+  #endif
+  return 0;
+}
@@ -0,0 +1,84 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+/**
+  * @file thread_pool.hpp
+  * @brief Work-stealing pool of threads, and memory budget of its tasks.
+  * @date 17-10-2026
+  * @copyright MIT
+  * @version 0.1
+  */
+
+// Configuration file
+#include "config.h"
+// C libraries
+#include <stddef.h> // size_t
+// STL
+#include <deque>    // task queues
+#include <vector>   // workers and queues
+#include <memory>   // std::unique_ptr (queues)
+#include <functional> // task_t
+#include <mutex>    // std::mutex, std::unique_lock
+#include <condition_variable> // memory_budget_t::acquire(1)
+
+/** @class thread_pool_t
+  * @brief Runs a batch of independent tasks on a fixed number of threads.
+  *
+  *  Tasks are dealt to the workers in turn when they are submitted. Each worker
+  *  runs the tasks of its own queue in submission order, and steals the last task
+  *  of another queue once its own is empty, such that long tasks do not leave
+  *  the other workers idle at the end of the batch.
+  */
+class thread_pool_t {
+public:
+  typedef std::function<void()> task_t;
+
+  /** @param[in] <threads> Number of workers (0: one per core). */
+  explicit thread_pool_t(unsigned int threads);
+  /** Number of workers. */
+  unsigned int size() const;
+  /** Queue a task, until the next call to run(0). */
+  void submit(const task_t & task);
+  /** Run every queued task and return once they are all done.
+    * @remark If a task throws, the other tasks still run, and the first exception is rethrown.
+    */
+  void run();
+
+private:
+  struct queue_t {
+    std::mutex mutex;
+    std::deque<task_t> tasks;
+  };
+  /** Take the next task of the worker: the first one of its queue, or the last one of another queue. */
+  bool next_task(unsigned int worker, task_t & task);
+
+  std::vector< std::unique_ptr<queue_t> > queues_;
+  /// Queue of the next submitted task.
+  unsigned int next_queue_;
+};
+
+/** @class memory_budget_t
+  * @brief Bytes that concurrent tasks may reserve (estimates of their peak memory).
+  */
+class memory_budget_t {
+public:
+  /** @param[in] <bytes> Budget (0: three quarters of the physical memory). */
+  explicit memory_budget_t(size_t bytes);
+  /** Total budget. */
+  size_t capacity() const;
+  /** Wait until @p bytes are available and reserve them. A reservation larger
+    * than the budget waits until nothing else is reserved.
+    */
+  void acquire(size_t bytes);
+  /** Release bytes reserved by acquire(1). */
+  void release(size_t bytes);
+  /** Physical memory of the machine, in bytes (0 if unknown). */
+  static size_t physical_memory();
+
+private:
+  size_t capacity_;
+  size_t reserved_;
+  std::mutex mutex_;
+  std::condition_variable released_;
+};
+
+#endif //THREAD_POOL_HPP
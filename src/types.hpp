@@ -63,6 +63,18 @@ typedef struct bool_opt_t {
   void init(bool init_value) {value=init_value;initialized=true;}
 } bool_opt_t;
 
+/// Scalar statistics of a realization (aggregated over the realizations of ensembles and sweeps).
+typedef struct network_summary_t {
+  enum field_t {NODES, CLUSTERS, MEAN_SIZE, MAX_SIZE, MEAN_MEMBERSHIP, MAX_MEMBERSHIP, INTERNAL_LINKS, DURATION, FIELDS};
+  /// network_summary_t::values contains the statistics, indexed by field_t.
+  double values[FIELDS];
+  /// Name of a statistic (statistics files).
+  static const char * name(unsigned int field) {
+    static const char * names[FIELDS] = {"nodes", "clusters", "mean_size", "max_size", "mean_membership", "max_membership", "internal_links", "duration"};
+    return names[field];
+  }
+} network_summary_t;
+
 /// Program parameters structure
 typedef struct spa_parameters_t {
   //Mandatory~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -74,7 +86,7 @@ typedef struct spa_parameters_t {
   double_opt_t r;
   /// Final size of the network (in nodes).
   uint_opt_t final_size;
-  /// Seed of the pseudo random number generator (Mersenne-twister 19937).
+  /// Seed of the pseudo random number generator.
   uint_opt_t seed;
   //Output files~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   /// Edge file path (output).
@@ -112,6 +124,26 @@ typedef struct spa_parameters_t {
   str_opt_t base_path;
   /// Append option: if true all outputs are appended, instead of written over existing content.
   bool_opt_t append;
+  /// Output format: text, binary (CSR layout, see binary_output.hpp) or compressed (edge lists, see compressed_edge_list.hpp).
+  str_opt_t format;
+  /// Pseudo random number generator (mt19937, xoshiro256pp, pcg64 or philox).
+  str_opt_t engine;
+  /// Deferred link handling: subgraphs are built after the growth of the communities, in parallel.
+  bool_opt_t deferred_links;
+  /// Number of threads of the parallel steps (0: one per core).
+  uint_opt_t threads;
+  /// Relaxed-consistency growth: tolerance on the deviation of the preferential picks (0: sequential growth).
+  double_opt_t relaxed;
+  /// Validation of the relaxed growth: compare with a sequential realization.
+  bool_opt_t validate_relaxed;
+  /// Number of realizations, grown concurrently (ensemble mode).
+  uint_opt_t realizations;
+  /// Index of the realization: streams are keyed by the seed and this index (realization i of an ensemble).
+  uint_opt_t realization;
+  /// Memory budget of the concurrent realizations, in MB (0: three quarters of the physical memory).
+  uint_opt_t memory_limit;
+  /// Parameter sweep: grid of values of p, q, r, basic_size, final_size and initial_size (see expand_sweep(3)).
+  str_opt_t sweep;
 
   /**  Replace non-initialized parameters in param1 by initialized parameters in param2. 
     *  @remark Parameters that are already initialized in param1 are not modified. 
@@ -139,9 +171,34 @@ typedef struct spa_parameters_t {
     if ( !initial_size.initialized && rhs.initial_size.initialized ) initial_size.init(rhs.initial_size.value);
     if ( !base_path.initialized && rhs.base_path.initialized ) base_path.init(rhs.base_path.value);
     if ( !append.initialized && rhs.append.initialized ) append.init(rhs.append.value);
+    if ( !format.initialized && rhs.format.initialized ) format.init(rhs.format.value);
+    if ( !engine.initialized && rhs.engine.initialized ) engine.init(rhs.engine.value);
+    if ( !deferred_links.initialized && rhs.deferred_links.initialized ) deferred_links.init(rhs.deferred_links.value);
+    if ( !threads.initialized && rhs.threads.initialized ) threads.init(rhs.threads.value);
+    if ( !relaxed.initialized && rhs.relaxed.initialized ) relaxed.init(rhs.relaxed.value);
+    if ( !validate_relaxed.initialized && rhs.validate_relaxed.initialized ) validate_relaxed.init(rhs.validate_relaxed.value);
+    if ( !realizations.initialized && rhs.realizations.initialized ) realizations.init(rhs.realizations.value);
+    if ( !realization.initialized && rhs.realization.initialized ) realization.init(rhs.realization.value);
+    if ( !memory_limit.initialized && rhs.memory_limit.initialized ) memory_limit.init(rhs.memory_limit.value);
+    if ( !sweep.initialized && rhs.sweep.initialized ) sweep.init(rhs.sweep.value);
     return;
   }
 
+  /// True if the requested outputs need the links (complete simulation mode).
+  bool links_requested() const {
+    return (edge_list.initialized || degrees.initialized || 
+            internal_degrees.initialized || projected_internal_degrees.initialized);
+  }
+  /// True if one or more output is redirected to the stdout.
+  bool stdout_requested() const {
+    const str_opt_t * outputs[] = {&edge_list, &connected_edge_list, &cluster_contents, &node_participations,
+                                   &cluster_sizes, &node_memberships, &degrees, &connected_degrees,
+                                   &internal_degrees, &projected_internal_degrees, &collapsed_internal_degrees, &timer};
+    for (size_t i = 0; i < sizeof(outputs) / sizeof(outputs[0]); ++i) {
+      if (outputs[i]->initialized && outputs[i]->value.empty()) return true;
+    }
+    return false;
+  }
   /// True if one or more output path is initialized.
   bool output_requested() const {
     return (edge_list.initialized || connected_edge_list.initialized  || 
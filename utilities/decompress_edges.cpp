@@ -0,0 +1,137 @@
+// Convert a compressed edge list (see src/compressed_edge_list.hpp) back to text.
+//
+//   decompress_edges edges.dvz                        all the edges
+//   decompress_edges edges.dvz first_node last_node   the edges (u, v) with first_node <= u <= last_node
+//
+// The second form reads the block index, and only decodes the blocks that may contain the edges.
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// copies of compressed_header_t, compressed_block_t and compressed_trailer_t (src/compressed_edge_list.hpp)
+struct header_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t block_edges;
+    uint32_t reserved;
+    uint64_t edges;
+};
+struct block_t {
+    uint64_t position;
+    uint32_t first_u;
+    uint32_t first_v;
+};
+struct trailer_t {
+    uint64_t index_position;
+    uint64_t blocks;
+};
+static_assert(sizeof(header_t) == 32, "header_t must match compressed_header_t (32 bytes).");
+static_assert(sizeof(block_t) == 16, "block_t must match compressed_block_t (16 bytes).");
+static_assert(sizeof(trailer_t) == 16, "trailer_t must match compressed_trailer_t (16 bytes).");
+
+bool get_varint(std::istream & file, uint32_t & value) {
+    value = 0;
+    for (unsigned int shift = 0; shift < 35; shift += 7) {
+        int byte = file.get();
+        if (byte == EOF) return false;
+        value |= (uint32_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc != 2 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " edges.dvz [first_node last_node]\n";
+        return 1;
+    }
+    std::string path = argv[1];
+    uint32_t first_node = 0, last_node = UINT32_MAX;
+    if (argc == 4) {
+        first_node = (uint32_t) strtoul(argv[2], NULL, 10);
+        last_node = (uint32_t) strtoul(argv[3], NULL, 10);
+    }
+
+    std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Could not open " + path + "\n";
+        return 1;
+    }
+    header_t header;
+    trailer_t trailer;
+    file.read((char *) &header, sizeof(header));
+    if (!file || memcmp(header.magic, "SPA-DVE", 8) != 0 || header.version != 1) {
+        std::cerr << path + " is not a compressed edge list (version 1).\n";
+        return 1;
+    }
+    if (header.byte_order != 0x01020304) {
+        std::cerr << path + " was written on a machine with another byte order.\n";
+        return 1;
+    }
+    file.seekg(0, std::ios::end);
+    const uint64_t file_size = (uint64_t) file.tellg();
+    file.seekg(-(std::streamoff) sizeof(trailer), std::ios::end);
+    file.read((char *) &trailer, sizeof(trailer));
+    // the index fills the file between the blocks and the trailer (checked before allocating it)
+    const uint64_t expected_blocks = header.block_edges == 0 ? 0 : (header.edges + header.block_edges - 1) / header.block_edges;
+    if (!file || file_size < sizeof(header) + sizeof(trailer) || header.block_edges == 0 || trailer.blocks != expected_blocks ||
+        trailer.index_position < sizeof(header) || trailer.index_position > file_size - sizeof(trailer) ||
+        (file_size - sizeof(trailer) - trailer.index_position) / sizeof(block_t) != trailer.blocks ||
+        (file_size - sizeof(trailer) - trailer.index_position) % sizeof(block_t) != 0) {
+        std::cerr << path + " is not a compressed edge list (truncated or corrupt index).\n";
+        return 1;
+    }
+    std::vector<block_t> index(trailer.blocks);
+    file.seekg(trailer.index_position);
+    file.read((char *) index.data(), index.size() * sizeof(block_t));
+    if (!file) {
+        std::cerr << "Could not read the block index of " + path + "\n";
+        return 1;
+    }
+
+    // the edges of first_node may begin in the last block that starts before it
+    size_t block = 0;
+    while (block + 1 < index.size() && index[block + 1].first_u < first_node) ++block;
+
+    std::string buffer;
+    uint64_t edge = block * (uint64_t) header.block_edges;
+    uint32_t u = 0, v = 0;
+    for (; block < index.size(); ++block) {
+        if (index[block].first_u > last_node) break;
+        file.seekg(index[block].position);
+        uint64_t block_end = std::min(edge + header.block_edges, header.edges);
+        for (bool first = true; edge < block_end; ++edge, first = false) {
+            uint32_t du, dv;
+            if (!get_varint(file, du) || !get_varint(file, dv)) {
+                std::cerr << "Truncated block " << block << " in " + path + "\n";
+                return 1;
+            }
+            if (first) {
+                u = du;
+                v = u + dv + 1;
+            }
+            else if (du == 0) v += dv + 1;
+            else {
+                u += du;
+                v = u + dv + 1;
+            }
+            if (u > last_node) break;
+            if (u >= first_node) {
+                buffer += std::to_string(u);
+                buffer += ' ';
+                buffer += std::to_string(v);
+                buffer += '\n';
+            }
+        }
+        edge = block_end;
+        std::cout << buffer;
+        buffer.clear();
+    }
+    return 0;
+}